@@ -0,0 +1,324 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include "AABBTree.h"
+#include <algorithm>            // For std::min, std::max, std::nth_element
+
+using namespace Raven;
+
+void AABBTree::clear() {
+    nodes.clear();
+    leafByEntity.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+}
+
+std::int32_t AABBTree::allocateNode() {
+    if (freeList == NULL_NODE) {
+        nodes.push_back(Node());
+        freeList = std::int32_t(nodes.size() - 1);
+        nodes[freeList].parent = NULL_NODE;
+    }
+    std::int32_t node = freeList;
+    freeList = nodes[node].parent;
+    nodes[node].parent = NULL_NODE;
+    nodes[node].child1 = NULL_NODE;
+    nodes[node].child2 = NULL_NODE;
+    nodes[node].height = 0;
+    return node;
+}
+
+void AABBTree::freeNode(std::int32_t node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+std::int32_t AABBTree::createLeaf(const ColliderBounds &bounds) {
+    std::int32_t leaf = allocateNode();
+    Node &node = nodes[leaf];
+    node.bounds = bounds;
+    node.left = bounds.left - margin;
+    node.top = bounds.top - margin;
+    node.right = bounds.right + margin;
+    node.bottom = bounds.bottom + margin;
+    leafByEntity[bounds.entity.id().id()] = leaf;
+    return leaf;
+}
+
+float AABBTree::unionCost(const Node &a, const Node &b) {
+    return (std::max(a.right, b.right) - std::min(a.left, b.left)) +
+        (std::max(a.bottom, b.bottom) - std::min(a.top, b.top));
+}
+
+void AABBTree::refit(std::int32_t node) {
+    Node &n = nodes[node];
+    const Node &a = nodes[n.child1];
+    const Node &b = nodes[n.child2];
+    n.height = 1 + std::max(a.height, b.height);
+    n.left = std::min(a.left, b.left);
+    n.top = std::min(a.top, b.top);
+    n.right = std::max(a.right, b.right);
+    n.bottom = std::max(a.bottom, b.bottom);
+}
+
+void AABBTree::build(const std::vector<ColliderBounds> &bounds) {
+    clear();
+    if (bounds.empty()) {
+        return;
+    }
+
+    nodes.reserve(bounds.size() * 2);
+    std::vector<std::int32_t> leaves;
+    leaves.reserve(bounds.size());
+    for (const ColliderBounds &b : bounds) {
+        // A repeated entity keeps only its last bounds, as with insert()
+        auto it = leafByEntity.find(b.entity.id().id());
+        if (it != leafByEntity.end()) {
+            nodes[it->second].bounds = b;
+            nodes[it->second].left = b.left - margin;
+            nodes[it->second].top = b.top - margin;
+            nodes[it->second].right = b.right + margin;
+            nodes[it->second].bottom = b.bottom + margin;
+            continue;
+        }
+        leaves.push_back(createLeaf(b));
+    }
+
+    root = buildRange(leaves, 0, leaves.size());
+    nodes[root].parent = NULL_NODE;
+}
+
+/*
+ * Splits the leaves at the median of their centres along the axis in which the centres are
+ * most spread out, which yields a tree of minimal height in a single pass.
+ */
+std::int32_t AABBTree::buildRange(std::vector<std::int32_t> &leaves, std::size_t first, std::size_t last) {
+    if (last - first == 1) {
+        return leaves[first];
+    }
+
+    float minX = nodes[leaves[first]].left + nodes[leaves[first]].right, maxX = minX;
+    float minY = nodes[leaves[first]].top + nodes[leaves[first]].bottom, maxY = minY;
+    for (std::size_t i = first + 1; i < last; ++i) {
+        const Node &n = nodes[leaves[i]];
+        minX = std::min(minX, n.left + n.right);
+        maxX = std::max(maxX, n.left + n.right);
+        minY = std::min(minY, n.top + n.bottom);
+        maxY = std::max(maxY, n.top + n.bottom);
+    }
+
+    std::size_t middle = (first + last) / 2;
+    bool splitX = maxX - minX >= maxY - minY;
+    std::nth_element(leaves.begin() + first, leaves.begin() + middle, leaves.begin() + last,
+        [this, splitX](std::int32_t a, std::int32_t b) {
+        return splitX ? nodes[a].left + nodes[a].right < nodes[b].left + nodes[b].right :
+            nodes[a].top + nodes[a].bottom < nodes[b].top + nodes[b].bottom;
+    });
+
+    std::int32_t child1 = buildRange(leaves, first, middle);
+    std::int32_t child2 = buildRange(leaves, middle, last);
+    std::int32_t node = allocateNode();
+    nodes[node].child1 = child1;
+    nodes[node].child2 = child2;
+    nodes[child1].parent = node;
+    nodes[child2].parent = node;
+    refit(node);
+    return node;
+}
+
+void AABBTree::insert(const ColliderBounds &bounds) {
+    remove(bounds.entity.id());
+    insertLeaf(createLeaf(bounds));
+}
+
+bool AABBTree::remove(ex::Entity::Id id) {
+    auto it = leafByEntity.find(id.id());
+    if (it == leafByEntity.end()) {
+        return false;
+    }
+    std::int32_t leaf = it->second;
+    leafByEntity.erase(it);
+    removeLeaf(leaf);
+    freeNode(leaf);
+    return true;
+}
+
+bool AABBTree::move(const ColliderBounds &bounds) {
+    auto it = leafByEntity.find(bounds.entity.id().id());
+    if (it != leafByEntity.end()) {
+        Node &leaf = nodes[it->second];
+        if (leaf.left <= bounds.left && leaf.top <= bounds.top &&
+            bounds.right <= leaf.right && bounds.bottom <= leaf.bottom) {
+            leaf.bounds = bounds;
+            return false;
+        }
+    }
+    insert(bounds);
+    return true;
+}
+
+const ColliderBounds *AABBTree::find(ex::Entity::Id id) const {
+    auto it = leafByEntity.find(id.id());
+    return it == leafByEntity.end() ? nullptr : &nodes[it->second].bounds;
+}
+
+/*
+ * Descends towards whichever child would grow the least by taking in the leaf, stopping early
+ * when pairing the leaf with the current node directly is cheaper than going deeper.
+ */
+void AABBTree::insertLeaf(std::int32_t leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    std::int32_t index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node &node = nodes[index];
+        const Node &child1 = nodes[node.child1];
+        const Node &child2 = nodes[node.child2];
+        const Node &newLeaf = nodes[leaf];
+
+        float area = (node.right - node.left) + (node.bottom - node.top);
+        float combinedArea = unionCost(node, newLeaf);
+
+        // The cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+
+        // The minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+        float cost1 = unionCost(child1, newLeaf) + inheritanceCost;
+        if (!child1.isLeaf()) {
+            cost1 -= (child1.right - child1.left) + (child1.bottom - child1.top);
+        }
+        float cost2 = unionCost(child2, newLeaf) + inheritanceCost;
+        if (!child2.isLeaf()) {
+            cost2 -= (child2.right - child2.left) + (child2.bottom - child2.top);
+        }
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    // Replace the sibling with a new parent holding both the sibling and the leaf
+    std::int32_t sibling = index;
+    std::int32_t oldParent = nodes[sibling].parent;
+    std::int32_t newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+    if (oldParent == NULL_NODE) {
+        root = newParent;
+    }
+    else if (nodes[oldParent].child1 == sibling) {
+        nodes[oldParent].child1 = newParent;
+    }
+    else {
+        nodes[oldParent].child2 = newParent;
+    }
+
+    // Walk back up, fixing the boxes and heights and rebalancing on the way
+    for (index = newParent; index != NULL_NODE; index = nodes[index].parent) {
+        index = balance(index);
+        refit(index);
+    }
+}
+
+void AABBTree::removeLeaf(std::int32_t leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    std::int32_t parent = nodes[leaf].parent;
+    std::int32_t grandParent = nodes[parent].parent;
+    std::int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    // The sibling takes the place of the parent
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        return;
+    }
+    if (nodes[grandParent].child1 == parent) {
+        nodes[grandParent].child1 = sibling;
+    }
+    else {
+        nodes[grandParent].child2 = sibling;
+    }
+
+    for (std::int32_t index = grandParent; index != NULL_NODE; index = nodes[index].parent) {
+        index = balance(index);
+        refit(index);
+    }
+}
+
+/*
+ * A standard AVL rotation: the taller child is promoted to the node's place, and the node
+ * adopts whichever of that child's children is shorter.
+ */
+std::int32_t AABBTree::balance(std::int32_t a) {
+    if (nodes[a].isLeaf() || nodes[a].height < 2) {
+        return a;
+    }
+
+    std::int32_t b = nodes[a].child1;
+    std::int32_t c = nodes[a].child2;
+    int difference = nodes[c].height - nodes[b].height;
+    if (difference >= -1 && difference <= 1) {
+        return a;
+    }
+
+    // Promote the taller child (up) over a, keeping the shorter child (other) in place
+    bool promoteSecond = difference > 1;
+    std::int32_t up = promoteSecond ? c : b;
+
+    // Swap a and up
+    std::int32_t parent = nodes[a].parent;
+    nodes[up].parent = parent;
+    nodes[a].parent = up;
+    if (parent == NULL_NODE) {
+        root = up;
+    }
+    else if (nodes[parent].child1 == a) {
+        nodes[parent].child1 = up;
+    }
+    else {
+        nodes[parent].child2 = up;
+    }
+
+    // The taller grandchild stays with up, the shorter one moves under a
+    std::int32_t f = nodes[up].child1;
+    std::int32_t g = nodes[up].child2;
+    std::int32_t keep = nodes[f].height > nodes[g].height ? f : g;
+    std::int32_t move = keep == f ? g : f;
+
+    nodes[up].child1 = a;
+    nodes[up].child2 = keep;
+    if (promoteSecond) {
+        nodes[a].child2 = move;
+    }
+    else {
+        nodes[a].child1 = move;
+    }
+    nodes[move].parent = a;
+
+    refit(a);
+    refit(up);
+    return up;
+}
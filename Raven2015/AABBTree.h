@@ -0,0 +1,269 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include <algorithm>            // For std::min, std::max
+#include <cstdint>              // For std::int32_t, std::uint64_t
+#include <limits>               // For std::numeric_limits
+#include <unordered_map>        // For std::unordered_map
+#include <vector>               // For std::vector
+#include "Broadphase.h"         // For ColliderBounds
+
+namespace Raven {
+
+    /*
+     * A bounding-volume hierarchy over collider bounds, keyed by entity ID. The tree can be
+     * built in one pass over a known set of colliders, and is kept balanced with rotations
+     * when colliders are inserted or removed afterwards.
+     *
+     * Leaves may be fattened by a margin so that a moving collider only has to be re-inserted
+     * once it leaves its enlarged box, rather than every time it moves.
+     */
+    class AABBTree {
+    public:
+        // Marks the absence of a node
+        static const std::int32_t NULL_NODE = -1;
+
+        explicit AABBTree(float margin = 0.0f) : margin(margin), root(NULL_NODE), freeList(NULL_NODE) {}
+
+        // Removes every collider
+        void clear();
+
+        // Replaces the contents of the tree with a balanced hierarchy over the given colliders
+        void build(const std::vector<ColliderBounds> &bounds);
+
+        // Adds a collider. A collider already in the tree is replaced.
+        void insert(const ColliderBounds &bounds);
+
+        // Removes the collider of the given entity. Returns whether it was present.
+        bool remove(ex::Entity::Id id);
+
+        /*
+         * Updates the bounds of a collider, inserting it if it is not in the tree yet.
+         * The tree is only restructured if the new bounds poke out of the leaf's fat box.
+         * Returns whether the collider was (re-)inserted.
+         */
+        bool move(const ColliderBounds &bounds);
+
+        // The bounds stored for the given entity, or nullptr if it is not in the tree
+        const ColliderBounds *find(ex::Entity::Id id) const;
+
+        // The number of colliders in the tree
+        std::size_t size() const { return leafByEntity.size(); }
+
+        // The number of levels below the root (0 for an empty tree or a single collider)
+        int getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+        // How far each leaf's box extends beyond its collider on every side
+        float getMargin() const { return margin; }
+
+        /*
+         * Invokes callback(const ColliderBounds &) for every collider whose bounds touch
+         * or overlap the given box. Does not allocate, so it may be called concurrently.
+         */
+        template <typename Callback>
+        void query(float left, float top, float right, float bottom, Callback &&callback) const;
+
+        /*
+         * Walks the segment from (x0, y0) to (x1, y1). Invokes callback(const ColliderBounds &,
+         * float maxFraction) for every collider whose box the remaining segment may cross; the
+         * callback returns the fraction of the segment to which the search is clipped from then on
+         * (e.g. the fraction of a hit, to find only the closest one). Does not allocate.
+         */
+        template <typename Callback>
+        void raycast(float x0, float y0, float x1, float y1, Callback &&callback) const;
+
+        /*
+         * Visits colliders in roughly increasing distance from (x, y). Invokes callback(const
+         * ColliderBounds &, float distanceSquared) for every collider no further away than the
+         * current bound, which the callback returns (e.g. the distance of the k-th closest
+         * collider found so far). Subtrees beyond the bound are skipped. Does not allocate.
+         */
+        template <typename Callback>
+        void nearest(float x, float y, Callback &&callback) const;
+
+        // Invokes callback(const ColliderBounds &) for every collider in the tree
+        template <typename Callback>
+        void forEach(Callback &&callback) const {
+            for (const Node &node : nodes) {
+                if (node.height == 0) {
+                    callback(node.bounds);
+                }
+            }
+        }
+
+    private:
+        // The deepest stack a query supports; far beyond the height of a balanced tree
+        static const int MAX_STACK = 256;
+
+        struct Node {
+            // The box enclosing every collider below the node
+            float left, top, right, bottom;
+
+            // The collider held by a leaf
+            ColliderBounds bounds;
+
+            // The parent of an allocated node, or the next free node while in the free list
+            std::int32_t parent;
+
+            // The children of an internal node (NULL_NODE for leaves)
+            std::int32_t child1, child2;
+
+            // Leaves have a height of 0; free nodes have a height of -1
+            int height;
+
+            bool isLeaf() const { return child1 == NULL_NODE; }
+
+            // The squared distance from a point to the node's box (0 inside the box)
+            float distanceSquared(float x, float y) const {
+                float dx = x < left ? left - x : (x > right ? x - right : 0.0f);
+                float dy = y < top ? top - y : (y > bottom ? y - bottom : 0.0f);
+                return dx * dx + dy * dy;
+            }
+        };
+
+        // Takes a node from the free list, growing the pool when it is empty
+        std::int32_t allocateNode();
+
+        // Returns a node to the free list
+        void freeNode(std::int32_t node);
+
+        // Allocates a leaf holding the given bounds
+        std::int32_t createLeaf(const ColliderBounds &bounds);
+
+        // Recursively builds a subtree over leaves[first, last)
+        std::int32_t buildRange(std::vector<std::int32_t> &leaves, std::size_t first, std::size_t last);
+
+        // Links an allocated leaf into the tree next to the cheapest sibling
+        void insertLeaf(std::int32_t leaf);
+
+        // Unlinks a leaf from the tree without freeing it
+        void removeLeaf(std::int32_t leaf);
+
+        // Performs a rotation at the node if its subtrees' heights differ by more than one.
+        // Returns the node that now sits at its place in the tree.
+        std::int32_t balance(std::int32_t node);
+
+        // Recomputes a node's height and box from its children
+        void refit(std::int32_t node);
+
+        // Half of the perimeter of the union of two boxes, the cost metric for insertion
+        static float unionCost(const Node &a, const Node &b);
+
+        // The fattening applied to every leaf
+        float margin;
+
+        std::vector<Node> nodes;
+        std::int32_t root;
+        std::int32_t freeList;
+
+        // Maps an entity ID to its leaf
+        std::unordered_map<std::uint64_t, std::int32_t> leafByEntity;
+    };
+
+    template <typename Callback>
+    void AABBTree::query(float left, float top, float right, float bottom, Callback &&callback) const {
+        if (root == NULL_NODE) {
+            return;
+        }
+
+        std::int32_t stack[MAX_STACK];
+        int count = 0;
+        stack[count++] = root;
+        while (count > 0) {
+            const Node &node = nodes[stack[--count]];
+            if (node.left > right || left > node.right || node.top > bottom || top > node.bottom) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                callback(node.bounds);
+            }
+            else if (count + 2 <= MAX_STACK) {
+                stack[count++] = node.child1;
+                stack[count++] = node.child2;
+            }
+        }
+    }
+
+    template <typename Callback>
+    void AABBTree::raycast(float x0, float y0, float x1, float y1, Callback &&callback) const {
+        if (root == NULL_NODE) {
+            return;
+        }
+
+        float dx = x1 - x0, dy = y1 - y0;
+        float maxFraction = 1.0f;
+        std::int32_t stack[MAX_STACK];
+        int count = 0;
+        stack[count++] = root;
+        while (count > 0) {
+            const Node &node = nodes[stack[--count]];
+
+            // Clip [0, maxFraction] against the box's slabs, one axis at a time
+            float tMin = 0.0f, tMax = maxFraction;
+            bool missed = false;
+            const float origin[2] = { x0, y0 }, delta[2] = { dx, dy };
+            const float low[2] = { node.left, node.top }, high[2] = { node.right, node.bottom };
+            for (int axis = 0; axis < 2 && !missed; ++axis) {
+                if (delta[axis] == 0.0f) {
+                    missed = origin[axis] < low[axis] || origin[axis] > high[axis];
+                    continue;
+                }
+                float t1 = (low[axis] - origin[axis]) / delta[axis];
+                float t2 = (high[axis] - origin[axis]) / delta[axis];
+                tMin = std::max(tMin, std::min(t1, t2));
+                tMax = std::min(tMax, std::max(t1, t2));
+                missed = tMin > tMax;
+            }
+            if (missed) {
+                continue;
+            }
+
+            if (node.isLeaf()) {
+                maxFraction = std::min(maxFraction, callback(node.bounds, maxFraction));
+            }
+            else if (count + 2 <= MAX_STACK) {
+                stack[count++] = node.child1;
+                stack[count++] = node.child2;
+            }
+        }
+    }
+
+    template <typename Callback>
+    void AABBTree::nearest(float x, float y, Callback &&callback) const {
+        if (root == NULL_NODE) {
+            return;
+        }
+
+        float bound = std::numeric_limits<float>::infinity();
+        std::int32_t stack[MAX_STACK];
+        int count = 0;
+        stack[count++] = root;
+        while (count > 0) {
+            const Node &node = nodes[stack[--count]];
+            float distance = node.distanceSquared(x, y);
+            if (distance > bound) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                bound = callback(node.bounds, distance);
+            }
+            else if (count + 2 <= MAX_STACK) {
+                // Push the nearer child last so that it is searched first and tightens the bound
+                bool firstNearer = nodes[node.child1].distanceSquared(x, y) <= nodes[node.child2].distanceSquared(x, y);
+                stack[count++] = firstNearer ? node.child2 : node.child1;
+                stack[count++] = firstNearer ? node.child1 : node.child2;
+            }
+        }
+    }
+
+}
@@ -11,6 +11,10 @@ void AudioSystem::update(ex::EntityManager &es, ex::EventManager &events,
 
 }
 
+void AudioSystem::access(ex::ComponentAccess &access) const {
+    access.reads<SoundMaker, MusicMaker>();
+}
+
 /*
  * Responds to requests for operations regarding audio resources.
  */
@@ -65,6 +65,11 @@ namespace Raven {
         void update(ex::EntityManager &es, ex::EventManager &events,
             ex::TimeDelta dt) override;
 
+        /*
+         * Declares the components touched by update() for the SystemScheduler
+         */
+        void access(ex::ComponentAccess &access) const override;
+
         // Receives and processes AudioEvents
         void receive(const AudioEvent &event);
     };
@@ -0,0 +1,192 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include <algorithm>            // For std::max
+#include <chrono>               // For std::chrono::high_resolution_clock
+#include <cmath>                // For std::sqrt
+#include <cstdlib>              // For std::rand
+#include <iostream>             // For std::cout, std::endl
+#include <memory>               // For std::unique_ptr
+#include <vector>               // For std::vector
+#include "entityx\3rdparty\catch.hpp"   // For TEST_CASE, REQUIRE
+#include "CollisionSystem.h"
+#include "ComponentLibrary.h"   // For Transform, Rigidbody, BoxCollider
+#include "Narrowphase.h"        // For NarrowphaseBatch
+#include "RenderList.h"
+#include "SpriteBatch.h"
+#include "entityx\help\ThreadPool.h"    // For ex::help::ThreadPool
+
+using namespace Raven;
+
+namespace {
+    typedef std::chrono::high_resolution_clock Clock;
+
+    long long toMicroseconds(Clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    }
+}
+
+/*
+ * Builds random pairs of colliders, then times the per-pair testCollision against the
+ * batched SIMD narrowphase on the same pairs.
+ */
+TEST_CASE("BenchmarkNarrowphase", "[benchmark]") {
+    const std::size_t pairCount = 4096;
+    const int iterations = 100;
+
+    ex::EventManager events;
+    ex::EntityManager entities(events);
+    CollisionSystem system;
+
+    // Scatter the colliders over a small area so that roughly half of the pairs overlap
+    std::vector<ex::Entity> colliders;
+    std::vector<ColliderBounds> bounds;
+    for (std::size_t i = 0; i < pairCount * 2; ++i) {
+        ex::Entity entity = entities.create();
+        float x = float(std::rand() % 200), y = float(std::rand() % 200);
+        entity.assign<Transform>(x, y);
+        entity.assign<Rigidbody>();
+        entity.assign<BoxCollider>()->collisionSettings = cmn::CollisionInformation::SOLID;
+        colliders.push_back(entity);
+        bounds.push_back(ColliderBounds(entity, x - cmn::STD_UNITX * 0.5f, y - cmn::STD_UNITY * 0.5f,
+            x + cmn::STD_UNITX * 0.5f, y + cmn::STD_UNITY * 0.5f));
+    }
+
+    NarrowphaseBatch batch;
+    batch.reserve(pairCount);
+    for (std::size_t i = 0; i < pairCount; ++i) {
+        batch.add(bounds[2 * i], bounds[2 * i + 1]);
+    }
+
+    std::size_t perPairHits = 0, scalarHits = 0, batchHits = 0;
+    Contact contact;
+    std::vector<std::uint32_t> hits;
+
+    Clock::time_point start = Clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (std::size_t i = 0; i < pairCount; ++i) {
+            perPairHits += system.testCollision(colliders[2 * i], colliders[2 * i + 1], contact);
+        }
+    }
+    Clock::time_point perPairEnd = Clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        scalarHits += batch.testScalar(hits);
+    }
+    Clock::time_point scalarEnd = Clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        batchHits += batch.test(hits);
+    }
+    Clock::time_point batchEnd = Clock::now();
+
+    std::cout << "Narrowphase benchmark: " << pairCount << " pairs x " << iterations << " iterations" << std::endl;
+    std::cout << "  testCollision:    " << toMicroseconds(perPairEnd - start) << "us (" << perPairHits << " hits)" << std::endl;
+    std::cout << "  batch, scalar:    " << toMicroseconds(scalarEnd - perPairEnd) << "us (" << scalarHits << " hits)" << std::endl;
+    std::cout << "  batch, " << NarrowphaseBatch::LANES << " lanes:  " << toMicroseconds(batchEnd - scalarEnd) <<
+        "us (" << batchHits << " hits)" << std::endl;
+
+    REQUIRE(batchHits == scalarHits);
+}
+
+/*
+ * Fills a square world with colliders at roughly constant density, then times
+ * CollisionSystem::update with an increasing number of worker threads.
+ */
+TEST_CASE("BenchmarkCollisionWorkerThreads", "[benchmark]") {
+    const std::size_t colliderCount = 10000;
+    const std::size_t maxWorkers = ex::help::ThreadPool::default_workers();
+    const int iterations = 50;
+
+    ex::EventManager events;
+    ex::EntityManager entities(events);
+
+    int side = std::max(1, (int)std::sqrt(float(colliderCount)) * (int)cmn::STD_UNITX);
+    for (std::size_t i = 0; i < colliderCount; ++i) {
+        ex::Entity entity = entities.create();
+        entity.assign<Transform>(float(std::rand() % side), float(std::rand() % side));
+        entity.assign<Rigidbody>();
+        entity.assign<BoxCollider>()->collisionSettings = cmn::CollisionInformation::SOLID;
+    }
+
+    // Every thread count must find the same contacts
+    std::size_t serialContacts = 0;
+    std::cout << "Collision benchmark: " << colliderCount << " colliders x " << iterations << " iterations" << std::endl;
+    for (std::size_t threads = 0; threads <= maxWorkers; threads = threads ? threads * 2 : 1) {
+        CollisionSystem system;
+        system.setWorkerThreads(threads);
+
+        Clock::time_point start = Clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            system.update(entities, events, 0.0);
+            events.dispatch_all();
+        }
+        Clock::time_point end = Clock::now();
+
+        std::cout << "  " << threads << " worker threads: " << toMicroseconds(end - start) / iterations <<
+            "us per update (" << system.getContacts().size() << " contacts)" << std::endl;
+
+        if (threads == 0) {
+            serialContacts = system.getContacts().size();
+        }
+        REQUIRE(system.getContacts().size() == serialContacts);
+    }
+}
+
+/*
+ * Builds sprites spread over a few textures and layers, then times ordering them with a
+ * RenderList and building the batches. Nothing is drawn, so no window is needed. Reports the
+ * draw calls per frame with and without batching.
+ */
+TEST_CASE("BenchmarkSpriteBatch", "[benchmark]") {
+    const std::size_t spriteCount = 10000;
+    const std::size_t textureCount = 8;
+    const int iterations = 100;
+
+    // The textures are never loaded: batching only looks at their addresses
+    std::unique_ptr<sf::Texture[]> textures(new sf::Texture[textureCount]);
+    std::vector<RenderableSprite> sprites;
+    sprites.reserve(spriteCount);
+    for (std::size_t i = 0; i < spriteCount; ++i) {
+        sprites.push_back(RenderableSprite());
+        RenderableSprite &sprite = sprites.back();
+        sprite.renderLayer = cmn::ERenderingLayer(cmn::ERenderingLayer::Background + std::rand() % 2);
+        sprite.renderPriority = std::rand() % 4;
+        sprite.sprite.setTexture(textures[std::rand() % textureCount]);
+        sprite.sprite.setTextureRect(sf::IntRect(0, 0, int(cmn::STD_UNITX), int(cmn::STD_UNITY)));
+        sprite.sprite.setPosition(float(std::rand() % 1024), float(std::rand() % 768));
+    }
+
+    // Hand them over in draw order, as RenderingSystem does
+    RenderList list;
+    SpriteBatch batch;
+    Clock::time_point start = Clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        list.begin();
+        for (std::size_t i = 0; i < spriteCount; ++i) {
+            list.add(ex::Entity::Id(i, 1), sprites[i],
+                std::uint32_t(sprites[i].sprite.getTexture() - textures.get()) + 1);
+        }
+        list.end();
+
+        batch.clear();
+        for (const RenderRecord &record : list.getRecords()) {
+            batch.add(*record.renderable);
+        }
+    }
+    Clock::time_point end = Clock::now();
+
+    std::cout << "Sprite batch benchmark: " << spriteCount << " sprites, " << textureCount << " textures x " <<
+        iterations << " iterations" << std::endl;
+    std::cout << "  draw calls per frame: " << batch.getDrawCalls() << " batched, " << spriteCount << " unbatched" << std::endl;
+    std::cout << "  " << toMicroseconds(end - start) / iterations << "us per frame to order and batch them (" <<
+        list.getSortCount() << " sorts)" << std::endl;
+
+    REQUIRE(batch.getSpriteCount() == spriteCount);
+}
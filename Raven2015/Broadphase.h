@@ -0,0 +1,163 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include <algorithm>            // For std::sort
+#include <utility>              // For std::pair
+#include <vector>               // For std::vector
+#include "entityx\Entity.h"     // For ex::Entity
+#include "Common.h"             // For cmn::EBroadphase, cmn::CollisionMask
+
+namespace Raven {
+
+    /*
+     * The world-space extents of a single BoxCollider, cached once per tick so that
+     * the broadphase never has to go back through ComponentHandles.
+     */
+    struct ColliderBounds {
+
+        ColliderBounds(ex::Entity entity = ex::Entity(), float left = 0.0f, float top = 0.0f,
+            float right = 0.0f, float bottom = 0.0f,
+            cmn::CollisionMask layers = cmn::CollisionInformation::DEFAULT_LAYER,
+            cmn::CollisionMask collidingLayers = ~cmn::CollisionMask(0),
+            cmn::CollisionMask settings = cmn::CollisionInformation::NO_SETTINGS)
+            : entity(entity), left(left), right(right), top(top), bottom(bottom),
+            layers(layers), collidingLayers(collidingLayers), settings(settings),
+            displacementX(0.0f), displacementY(0.0f) {}
+
+        // Whether the layer matrix allows the two colliders to interact at all.
+        // Checked before any geometry so that incompatible layers cost a single AND.
+        bool canCollide(const ColliderBounds &other) const {
+            return (collidingLayers & other.layers) != 0;
+        }
+
+        // Whether the collider is swept for continuous collision detection this tick
+        bool isSwept() const {
+            return displacementX != 0.0f || displacementY != 0.0f;
+        }
+
+        // Whether the two bounds touch or overlap (edges count, matching testCollision)
+        bool overlaps(const ColliderBounds &other) const {
+            return left <= other.right && other.left <= right &&
+                top <= other.bottom && other.top <= bottom;
+        }
+
+        // The entity that owns the collider
+        ex::Entity entity;
+
+        // The minimum and maximum x-coordinates of the collider
+        float left, right;
+
+        // The minimum and maximum y-coordinates of the collider
+        float top, bottom;
+
+        // The layers the collider belongs to
+        cmn::CollisionMask layers;
+
+        // Every layer the collider's layers may collide with, according to the layer matrix
+        cmn::CollisionMask collidingLayers;
+
+        // The collider's CollisionInformation::ESetting bits
+        cmn::CollisionMask settings;
+
+        // How far a swept collider moved this tick. For swept colliders, the extents above
+        // cover the whole sweep rather than the collider's final position.
+        float displacementX, displacementY;
+    };
+
+    /*
+     * The interface shared by every broadphase the CollisionSystem can be built with.
+     * A broadphase is handed the bounds of every collider once per tick and must report
+     * each pair of overlapping colliders exactly once. The two entities of a pair come in no
+     * particular order; callers that need a canonical order (as CollisionSystem::detect does)
+     * must normalise it themselves.
+     * The search can be split into partitions so that it may be spread over several threads.
+     * Between updates, the colliders can also be looked up by area, which is what the
+     * SpatialIndex answers its queries with.
+     */
+    class Broadphase {
+    public:
+        typedef std::pair<ex::Entity, ex::Entity> EntityPair;
+
+        virtual ~Broadphase() {}
+
+        // Synchronizes the broadphase with the colliders' bounds for the current tick
+        virtual void update(const std::vector<ColliderBounds> &bounds) = 0;
+
+        // Notifies the broadphase that an entity lost its BoxCollider or was destroyed.
+        // Broadphases that rebuild from the bounds on every update can ignore this.
+        virtual void colliderRemoved(ex::Entity::Id id) {}
+
+        // Appends each overlapping pair of colliders, sorted by the entity indices as reported
+        void findPairs(std::vector<EntityPair> &pairs) {
+            std::size_t firstPair = pairs.size();
+            findPairs(pairs, 0, 1);
+            sortPairs(pairs, firstPair);
+        }
+
+        /*
+         * Appends, in no particular order, the overlapping pairs owned by one of partitionCount
+         * disjoint partitions of the broadphase. Every pair belongs to exactly one partition,
+         * and different partitions may be searched concurrently after update() has returned.
+         */
+        virtual void findPairs(std::vector<EntityPair> &pairs, std::size_t partition,
+            std::size_t partitionCount) const = 0;
+
+        /*
+         * Invokes callback(const ColliderBounds &) exactly once for every collider whose bounds,
+         * as handed to the last update(), touch or overlap the given box. Swept colliders are
+         * found anywhere along their sweep. Does not allocate.
+         */
+        template <typename Callback>
+        void query(float left, float top, float right, float bottom, Callback &&callback) const {
+            QueryCallback<Callback> visitor(callback);
+            queryBounds(left, top, right, bottom, visitor);
+        }
+
+        // The number of colliders handed to the last update()
+        virtual std::size_t size() const = 0;
+
+    protected:
+        // Receives the colliders found by a query, so that queries can be virtual without a std::function
+        class QueryVisitor {
+        public:
+            virtual void visit(const ColliderBounds &bounds) = 0;
+
+        protected:
+            ~QueryVisitor() {}
+        };
+
+        template <typename Callback>
+        class QueryCallback : public QueryVisitor {
+        public:
+            explicit QueryCallback(Callback &callback) : callback(callback) {}
+
+            void visit(const ColliderBounds &bounds) override { callback(bounds); }
+
+        private:
+            Callback &callback;
+        };
+
+        // Reports every collider touching the box to the visitor, as described for query()
+        virtual void queryBounds(float left, float top, float right, float bottom, QueryVisitor &visitor) const = 0;
+
+        // Sorts the pairs appended since firstPair so that results do not depend on internal ordering
+        static void sortPairs(std::vector<EntityPair> &pairs, std::size_t firstPair) {
+            std::sort(pairs.begin() + firstPair, pairs.end(), [](const EntityPair &a, const EntityPair &b) {
+                return a.first.id().index() != b.first.id().index() ?
+                    a.first.id().index() < b.first.id().index() :
+                    a.second.id().index() < b.second.id().index();
+            });
+        }
+    };
+
+}
@@ -1,63 +1,400 @@
 #include "CollisionSystem.h"
 #include "ComponentLibrary.h"
+#include "SpatialHash.h"
+#include "SweepAndPrune.h"
+#include "DynamicTree.h"
 #include "entityx\Entity.h"
-#include <algorithm>            //For std::min
+#include <algorithm>            //For std::min, std::sort, std::unique
+#include <cmath>                //For std::abs
 
 using namespace Raven;
 
+CollisionSystem::CollisionSystem(cmn::EBroadphase broadphaseType, float cellWidth, float cellHeight)
+    : staticTreeDirty(true) {
+    switch (broadphaseType) {
+    case cmn::EBroadphase::SWEEP_AND_PRUNE: broadphase.reset(new SweepAndPrune()); break;
+    case cmn::EBroadphase::AABB_TREE: broadphase.reset(new DynamicTree()); break;
+    case cmn::EBroadphase::SPATIAL_HASH:
+    default: broadphase.reset(new SpatialHash(cellWidth, cellHeight)); break;
+    }
+}
+
+void CollisionSystem::access(ex::ComponentAccess &access) const {
+    access.reads<BoxCollider, Rigidbody>().writes<Transform>();
+}
+
+ColliderBounds CollisionSystem::getBounds(ex::Entity entity, const Transform &transform, const BoxCollider &collider) {
+    float centerX = transform.transform.x + collider.originOffset.x;
+    float centerY = transform.transform.y + collider.originOffset.y;
+    float halfWidth = collider.width * 0.5f;
+    float halfHeight = collider.height * 0.5f;
+    return ColliderBounds(entity, centerX - halfWidth, centerY - halfHeight,
+        centerX + halfWidth, centerY + halfHeight, collider.layers,
+        cmn::CollisionInformation::getCollidingLayers(collider.layers), collider.collisionSettings);
+}
+
+void CollisionSystem::updateBounds(ex::EntityManager &es) {
+    colliderBounds.clear();
+    fixedBounds.clear();
+    es.each<Transform, BoxCollider>([&](ex::Entity entity, Transform &transform, BoxCollider &collider) {
+        ColliderBounds bounds = getBounds(entity, transform, collider);
+
+        // Fixed colliders live in the static tree and are only ever tested against dynamic ones
+        if (collider.hasSetting(cmn::CollisionInformation::FIXED)) {
+            fixedBounds.push_back(bounds);
+            return;
+        }
+
+        // A continuous collider that moved further than its own half-extent this tick could have
+        // passed straight through a thin collider, so its bounds are stretched over the whole move.
+        // Without a Rigidbody it has no velocity to sweep along, so it is treated as discrete.
+        if (collider.hasSetting(cmn::CollisionInformation::CONTINUOUS)) {
+            ex::ComponentHandle<Rigidbody> rigidbody = entity.component<Rigidbody>();
+            sf::Vector2f displacement = rigidbody ? rigidbody->velocity : sf::Vector2f();
+            if (std::abs(displacement.x) > collider.width * 0.5f || std::abs(displacement.y) > collider.height * 0.5f) {
+                bounds.displacementX = displacement.x;
+                bounds.displacementY = displacement.y;
+                bounds.left = std::min(bounds.left, bounds.left - displacement.x);
+                bounds.right = std::max(bounds.right, bounds.right - displacement.x);
+                bounds.top = std::min(bounds.top, bounds.top - displacement.y);
+                bounds.bottom = std::max(bounds.bottom, bounds.bottom - displacement.y);
+            }
+        }
+        colliderBounds.push_back(bounds);
+    });
+
+    broadphase->update(colliderBounds);
+    updateStaticTree();
+}
+
 /*
-* Iterate through all objects with Colliders and emit CollisionEvents.
+* Iterate through all objects with Colliders and post a CollisionContactEvent per contact.
 */
 void CollisionSystem::update(ex::EntityManager &es, ex::EventManager &events,
     ex::TimeDelta dt) {
 
-    collisionMap.clear();
+    // Hand the colliders' current positions to the broadphase
+    updateBounds(es);
+
+    // Map each entity index to its bounds so that candidate pairs can be packed without ComponentHandles
+    for (std::size_t i = 0; i < colliderBounds.size(); ++i) {
+        std::uint32_t index = colliderBounds[i].entity.id().index();
+        if (index >= boundsByEntity.size()) {
+            boundsByEntity.resize(index + 1);
+        }
+        boundsByEntity[index] = (std::uint32_t)i;
+    }
+
+    // Search for contacts, split over the worker threads when there are enough colliders to pay for it
+    bool parallel = workers && colliderBounds.size() >= PARALLEL_THRESHOLD;
+    std::size_t partitionCount = parallel ? (workers->size() + 1) * 4 : 1;
+    if (partitions.size() < partitionCount) {
+        partitions.resize(partitionCount);
+    }
+    if (parallel) {
+        workers->parallel_for(partitionCount, [&](std::size_t i) {
+            detect(partitions[i], i, partitionCount);
+        });
+    }
+    else {
+        detect(partitions[0], 0, 1);
+    }
+
+    // Merge the thread-local buffers; sorting below makes the order independent of the partitioning
+    contacts.clear();
+    for (std::size_t i = 0; i < partitionCount; ++i) {
+        contacts.insert(contacts.end(), partitions[i].contacts.begin(), partitions[i].contacts.end());
+    }
+
+    // Order by entity pair and collapse duplicates (e.g. reported by more than one broadphase structure)
+    std::sort(contacts.begin(), contacts.end());
+    contacts.erase(std::unique(contacts.begin(), contacts.end(), [](const Contact &a, const Contact &b) {
+        return a.samePair(b);
+    }), contacts.end());
 
-    es.each<BoxCollider>([&](ex::Entity leftEntity, BoxCollider &leftCollider) {
-        es.each<BoxCollider>([&](ex::Entity rightEntity, BoxCollider &rightCollider) {
+    rewindSweptColliders();
 
-            std::shared_ptr<sf::Vector2f> collisionPoint;
-            // If we are checking for a collision between two different objects...
-            if (leftEntity != rightEntity && (collisionPoint = testCollision(leftEntity, rightEntity))) {
+    // Queue the contacts rather than responding now; the responses run once, as a batch, when the
+    // frame dispatches its events. Posting is safe while other systems run on other threads.
+    for (const Contact &c : contacts) {
+        events.post<CollisionContactEvent>(es.get(c.leftId), es.get(c.rightId), c.point,
+            c.penetration, c.timeOfImpact, &events);
+    }
+}
 
-                // Check whether we already have a record of collisions involving these two entities
-                std::map<ex::Entity, std::set<ex::Entity>>::iterator it1 = collisionMap.find(leftEntity);
-                std::map<ex::Entity, std::set<ex::Entity>>::iterator it2 = collisionMap.find(rightEntity);
+void CollisionSystem::detect(Partition &partition, std::size_t index, std::size_t count) const {
 
-                // If leftEntity has collided with rightEntity one-way, do nothing
-                if (collisionMap.find(leftEntity) != collisionMap.cend() &&
-                    collisionMap[leftEntity].find(rightEntity) != collisionMap[leftEntity].cend()) {
+    partition.contacts.clear();
+    partition.narrowphase.clear();
+    partition.pairs.clear();
+    partition.packedPairs.clear();
 
-                    return;
-                }
+    // Pack the pairs whose settings allow a response into the narrowphase batch,
+    // so that batch index i refers to packedPairs[i]
+    auto consider = [&](const ColliderBounds &left, const ColliderBounds &right) {
+        cmn::CollisionMask sharedSettings = left.settings & right.settings;
+        if (!(sharedSettings & cmn::CollisionInformation::SOLID) || (sharedSettings & cmn::CollisionInformation::FIXED)) {
+            return;
+        }
 
-                // If rightEntity has collided with leftEntity one-way, do nothing
-                if (collisionMap.find(rightEntity) != collisionMap.cend() &&
-                    collisionMap[rightEntity].find(leftEntity) != collisionMap[rightEntity].cend()) {
+        // Swept colliders need the time of impact, so they skip the batched overlap test
+        if (left.isSwept() || right.isSwept()) {
+            Contact contact;
+            if (testSweptCollision(left, right, contact)) {
+                partition.contacts.push_back(contact);
+            }
+            return;
+        }
 
-                    return;
-                }
+        // Keep the lower entity index on the left so that each pair has exactly one representation
+        if (right.entity.id().index() < left.entity.id().index()) {
+            partition.narrowphase.add(right, left);
+            partition.packedPairs.push_back(std::make_pair(right.entity, left.entity));
+        }
+        else {
+            partition.narrowphase.add(left, right);
+            partition.packedPairs.push_back(std::make_pair(left.entity, right.entity));
+        }
+    };
+
+    // Only pairs the broadphase could not rule out proceed to the narrowphase
+    broadphase->findPairs(partition.pairs, index, count);
+    for (Broadphase::EntityPair &pair : partition.pairs) {
+        if (pair.first != pair.second) {
+            consider(colliderBounds[boundsByEntity[pair.first.id().index()]],
+                colliderBounds[boundsByEntity[pair.second.id().index()]]);
+        }
+    }
 
-                collisionMap[leftEntity].insert(rightEntity);
-                events.emit<CollisionEvent>(leftEntity, rightEntity, *collisionPoint, &events);
+    // Each dynamic collider looks itself up in the static tree; fixed colliders never look for each other
+    for (std::size_t i = index; i < colliderBounds.size(); i += count) {
+        const ColliderBounds &dynamic = colliderBounds[i];
+        staticTree.query(dynamic.left, dynamic.top, dynamic.right, dynamic.bottom, [&](const ColliderBounds &fixed) {
+            if (dynamic.canCollide(fixed)) {
+                consider(dynamic, fixed);
             }
         });
-    });
+    }
+
+    // Run the narrowphase, recording hits into the partition's contact buffer
+    partition.narrowphase.test(partition.hits);
+    for (std::size_t i = 0; i < partition.packedPairs.size(); ++i) {
+        if (!NarrowphaseBatch::isHit(partition.hits, i)) {
+            continue;
+        }
+        Contact contact;
+        contact.leftId = partition.packedPairs[i].first.id();
+        contact.rightId = partition.packedPairs[i].second.id();
+        contact.point = partition.narrowphase.getPoint(i);
+        contact.penetration = partition.narrowphase.getPenetration(i);
+        contact.timeOfImpact = 1.0f;
+        partition.contacts.push_back(contact);
+    }
+}
+
+/*
+ * Treats the right collider as stationary relative to the left one and casts the centre of the
+ * left collider along their relative motion against the right collider grown by the left one's
+ * half-extents (the slab method). Colliders that are not swept are taken at their final position.
+ */
+bool CollisionSystem::testSweptCollision(const ColliderBounds &left, const ColliderBounds &right, Contact &contact) {
+    // Recover each collider's final box from its (possibly stretched) bounds
+    float leftHalfWidth = (left.right - left.left - std::abs(left.displacementX)) * 0.5f;
+    float leftHalfHeight = (left.bottom - left.top - std::abs(left.displacementY)) * 0.5f;
+    float rightHalfWidth = (right.right - right.left - std::abs(right.displacementX)) * 0.5f;
+    float rightHalfHeight = (right.bottom - right.top - std::abs(right.displacementY)) * 0.5f;
+    sf::Vector2f leftEnd((left.left + left.right + left.displacementX) * 0.5f,
+        (left.top + left.bottom + left.displacementY) * 0.5f);
+    sf::Vector2f rightEnd((right.left + right.right + right.displacementX) * 0.5f,
+        (right.top + right.bottom + right.displacementY) * 0.5f);
+
+    sf::Vector2f leftStart(leftEnd.x - left.displacementX, leftEnd.y - left.displacementY);
+    sf::Vector2f rightStart(rightEnd.x - right.displacementX, rightEnd.y - right.displacementY);
+    sf::Vector2f motion(left.displacementX - right.displacementX, left.displacementY - right.displacementY);
+    sf::Vector2f reach(leftHalfWidth + rightHalfWidth, leftHalfHeight + rightHalfHeight);
+
+    // Find the interval of the tick during which the colliders overlap on both axes
+    float entry = 0.0f, exit = 1.0f;
+    float start[2] = { leftStart.x - rightStart.x, leftStart.y - rightStart.y };
+    float velocity[2] = { motion.x, motion.y };
+    float extent[2] = { reach.x, reach.y };
+    for (int axis = 0; axis < 2; ++axis) {
+        if (velocity[axis] == 0.0f) {
+            if (std::abs(start[axis]) > extent[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float t0 = (-extent[axis] - start[axis]) / velocity[axis];
+        float t1 = (extent[axis] - start[axis]) / velocity[axis];
+        entry = std::max(entry, std::min(t0, t1));
+        exit = std::min(exit, std::max(t0, t1));
+        if (entry > exit) {
+            return false;
+        }
+    }
+
+    // Keep the lower entity index on the left so that each pair has exactly one representation
+    bool swap = right.entity.id().index() < left.entity.id().index();
+    contact.leftId = swap ? right.entity.id() : left.entity.id();
+    contact.rightId = swap ? left.entity.id() : right.entity.id();
+
+    // Describe the contact as of the moment the colliders met
+    sf::Vector2f leftAtImpact = leftStart + sf::Vector2f(left.displacementX, left.displacementY) * entry;
+    sf::Vector2f rightAtImpact = rightStart + sf::Vector2f(right.displacementX, right.displacementY) * entry;
+    contact.point = (leftAtImpact + rightAtImpact) * 0.5f;
+    contact.penetration.x = reach.x - std::abs(leftAtImpact.x - rightAtImpact.x);
+    contact.penetration.y = reach.y - std::abs(leftAtImpact.y - rightAtImpact.y);
+    contact.timeOfImpact = entry;
+    return true;
+}
+
+/*
+ * Rather than shrinking the tick for everyone, only the swept colliders that actually hit
+ * something are moved back along their path to their earliest time of impact.
+ */
+void CollisionSystem::rewindSweptColliders() {
+    bool anyImpact = false;
+    for (const Contact &c : contacts) {
+        if (c.timeOfImpact >= 1.0f) {
+            continue;
+        }
+        if (!anyImpact) {
+            earliestImpact.assign(colliderBounds.size(), 1.0f);
+            anyImpact = true;
+        }
+        for (ex::Entity::Id id : { c.leftId, c.rightId }) {
+            // Fixed colliders are not in colliderBounds, and are never rewound anyway. Their index may
+            // lie beyond every dynamic collider's, so boundsByEntity is bounds-checked before it is read.
+            if (id.index() >= boundsByEntity.size()) {
+                continue;
+            }
+            std::uint32_t i = boundsByEntity[id.index()];
+            if (i >= colliderBounds.size() || colliderBounds[i].entity.id() != id) {
+                continue;
+            }
+            if (colliderBounds[i].isSwept() && !(colliderBounds[i].settings & cmn::CollisionInformation::FIXED)) {
+                earliestImpact[i] = std::min(earliestImpact[i], c.timeOfImpact);
+            }
+        }
+    }
+    if (!anyImpact) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < colliderBounds.size(); ++i) {
+        if (earliestImpact[i] < 1.0f) {
+            const ColliderBounds &bounds = colliderBounds[i];
+            ex::Entity entity = bounds.entity;
+            float remaining = 1.0f - earliestImpact[i];
+            entity.component<Transform>()->transform -=
+                sf::Vector2f(bounds.displacementX * remaining, bounds.displacementY * remaining);
+        }
+    }
+}
+
+/*
+ * The tree is rebuilt in one pass after a level has loaded. In between, fixed colliders that
+ * appeared or were moved (e.g. by the editor) are re-inserted individually.
+ */
+void CollisionSystem::updateStaticTree() {
+    if (staticTreeDirty) {
+        staticTree.build(fixedBounds);
+        staticTreeDirty = false;
+        return;
+    }
+
+    for (const ColliderBounds &bounds : fixedBounds) {
+        const ColliderBounds *stored = staticTree.find(bounds.entity.id());
+        if (!stored || stored->left != bounds.left || stored->top != bounds.top ||
+            stored->right != bounds.right || stored->bottom != bounds.bottom ||
+            stored->layers != bounds.layers || stored->settings != bounds.settings) {
+            staticTree.insert(bounds);
+        }
+    }
+
+    // Colliders that were destroyed or stopped being fixed are rare, so they trigger a rebuild
+    if (staticTree.size() != fixedBounds.size()) {
+        staticTree.build(fixedBounds);
+    }
+}
+
+void CollisionSystem::receive(const XMLLevelLoadedEvent &event) {
+    staticTreeDirty = true;
 }
 
-void CollisionSystem::receive(const CollisionEvent &event) {
+void CollisionSystem::receive(const ex::ComponentRemovedEvent<BoxCollider> &event) {
+    broadphase->colliderRemoved(event.entity.id());
+    staticTree.remove(event.entity.id());
+}
+
+void CollisionSystem::receive(const ex::EntityDestroyedEvent &event) {
+    broadphase->colliderRemoved(event.entity.id());
+    staticTree.remove(event.entity.id());
+}
+
+void CollisionSystem::setWorkerThreads(std::size_t threads) {
+    workers.reset(threads > 0 ? new ex::help::ThreadPool(threads) : nullptr);
+}
+
+/*
+ * Resolves each contact's components once, then hands every contact over in a single emit.
+ * Contacts whose entities were destroyed before the dispatch are dropped.
+ */
+void CollisionSystem::receive(const ex::EventSpan<CollisionContactEvent> &contacts) {
+    records.clear();
+    for (const CollisionContactEvent &c : contacts) {
+        if (!c.leftEntity.valid() || !c.rightEntity.valid()) {
+            continue;
+        }
+        CollisionRecord record;
+        record.leftEntity = c.leftEntity;
+        record.rightEntity = c.rightEntity;
+        record.leftTransform = record.leftEntity.component<Transform>();
+        record.leftRigidbody = record.leftEntity.component<Rigidbody>();
+        record.leftBoxCollider = record.leftEntity.component<BoxCollider>();
+        record.rightTransform = record.rightEntity.component<Transform>();
+        record.rightRigidbody = record.rightEntity.component<Rigidbody>();
+        record.rightBoxCollider = record.rightEntity.component<BoxCollider>();
+        record.collisionPoint = c.collisionPoint;
+        record.penetration = c.penetration;
+        record.timeOfImpact = c.timeOfImpact;
+        records.push_back(record);
+    }
+
+    if (!records.empty() && contacts[0].events) {
+        contacts[0].events->emit<CollisionBatchEvent>(records.data(), records.size(), contacts[0].events);
+    }
+}
+
+void CollisionSystem::receive(const CollisionBatchEvent &event) {
+    for (const CollisionRecord &record : event) {
+        respond(record.leftRigidbody, record.leftBoxCollider, record.rightRigidbody, record.rightBoxCollider);
+    }
+}
 
-    //cout << "Collision occurred" << endl;
+void CollisionSystem::receive(const ex::EventSpan<CollisionEvent> &events) {
+    for (const CollisionEvent &event : events) {
+        respond(event.leftRigidbody, event.leftBoxCollider, event.rightRigidbody, event.rightBoxCollider);
+    }
+}
+
+void CollisionSystem::respond(ex::ComponentHandle<Rigidbody> leftRigidbody,
+    ex::ComponentHandle<BoxCollider> leftBoxCollider, ex::ComponentHandle<Rigidbody> rightRigidbody,
+    ex::ComponentHandle<BoxCollider> rightBoxCollider) {
+
+    // Either side may have lost a component between the contact being found and being dispatched
+    if (!leftRigidbody || !rightRigidbody || !leftBoxCollider || !rightBoxCollider) {
+        return;
+    }
 
-    ex::ComponentHandle<Rigidbody> leftRigidbody = event.leftRigidbody;
-    ex::ComponentHandle<Rigidbody> rightRigidbody = event.rightRigidbody;
     sf::Vector2f avgVelocity = (leftRigidbody->velocity + rightRigidbody->velocity) / 2.0f;
     
-    if (event.leftBoxCollider->collisionSettings.find(COLLISION_LAYER_SETTINGS_FIXED) != event.leftBoxCollider->collisionSettings.end()) {
+    if (leftBoxCollider->hasSetting(cmn::CollisionInformation::FIXED)) {
         rightRigidbody->velocity -= avgVelocity;
     } 
 
-    if (event.rightBoxCollider->collisionSettings.find(COLLISION_LAYER_SETTINGS_FIXED) != event.rightBoxCollider->collisionSettings.end()) {
+    if (rightBoxCollider->hasSetting(cmn::CollisionInformation::FIXED)) {
         leftRigidbody->velocity -= avgVelocity;
     }
 }
@@ -65,8 +402,7 @@ void CollisionSystem::receive(const CollisionEvent &event) {
 /*
 * Tests whether two entities' colliders register a collision.
 */
-std::shared_ptr<sf::Vector2f> CollisionSystem::testCollision(ex::Entity leftEntity,
-    ex::Entity rightEntity) {
+bool CollisionSystem::testCollision(ex::Entity leftEntity, ex::Entity rightEntity, Contact &contact) {
 
     // Grab relevant components from left Entity
     ex::ComponentHandle<Transform> leftTransform = leftEntity.component<Transform>();
@@ -85,6 +421,13 @@ std::shared_ptr<sf::Vector2f> CollisionSystem::testCollision(ex::Entity leftEnti
         // TODO
     }
 
+    // Reject pairs whose settings can never produce a response before doing any geometry:
+    // both colliders must be solid, and at least one of them must be free to move
+    cmn::CollisionMask sharedSettings = leftBoxCollider->collisionSettings & rightBoxCollider->collisionSettings;
+    if (!(sharedSettings & cmn::CollisionInformation::SOLID) || (sharedSettings & cmn::CollisionInformation::FIXED)) {
+        return false;
+    }
+
     //Calculate the exact location of each collider
     float leftColliderX = leftTransform.get()->transform.x + leftBoxCollider.get()->originOffset.x;
     float leftColliderY = leftTransform.get()->transform.y + leftBoxCollider.get()->originOffset.y;
@@ -102,21 +445,21 @@ std::shared_ptr<sf::Vector2f> CollisionSystem::testCollision(ex::Entity leftEnti
     // Return whether the distance between objects is less than their reach towards each other on BOTH axes
     if (xDiff <= xReach && yDiff <= yReach) {
 
-        if (leftBoxCollider->collisionSettings.find(COLLISION_LAYER_SETTINGS_SOLID) != leftBoxCollider->collisionSettings.end() &&
-            rightBoxCollider->collisionSettings.find(COLLISION_LAYER_SETTINGS_SOLID) != rightBoxCollider->collisionSettings.end()) {
+        // Keep the lower entity index on the left so that each pair has exactly one representation
+        bool swap = rightEntity.id().index() < leftEntity.id().index();
+        contact.leftId = swap ? rightEntity.id() : leftEntity.id();
+        contact.rightId = swap ? leftEntity.id() : rightEntity.id();
 
-            if (!(leftBoxCollider->collisionSettings.find(COLLISION_LAYER_SETTINGS_FIXED) != leftBoxCollider->collisionSettings.end() &&
-                rightBoxCollider->collisionSettings.find(COLLISION_LAYER_SETTINGS_FIXED) != rightBoxCollider->collisionSettings.end())) {
-            
-                    // Approximate the collision point as directly in between the objects
-                    std::shared_ptr<sf::Vector2f> collisionPoint(new sf::Vector2f(0.5f * xDiff, 0.5f * yDiff));
-                    collisionPoint->x += std::min(leftColliderX, rightColliderX);
-                    collisionPoint->y += std::min(leftColliderY, rightColliderY);
+        // Approximate the collision point as directly in between the objects
+        contact.point.x = 0.5f * xDiff + std::min(leftColliderX, rightColliderX);
+        contact.point.y = 0.5f * yDiff + std::min(leftColliderY, rightColliderY);
 
-                    // Notify all of those listening for collisions that a collision has occurred
-                    return collisionPoint;
-            }
-        }
+        // Record how deeply the colliders have sunk into each other
+        contact.penetration.x = xReach - xDiff;
+        contact.penetration.y = yReach - yDiff;
+        contact.timeOfImpact = 1.0f;
+
+        return true;
     }
-    return nullptr;
-}
\ No newline at end of file
+    return false;
+}
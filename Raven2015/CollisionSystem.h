@@ -12,45 +12,204 @@
 #pragma once
 
 #include "entityx\System.h"
+#include "entityx\help\ThreadPool.h"    // For ex::help::ThreadPool
 #include "EventLibrary.h"
+#include "Broadphase.h"
+#include "Narrowphase.h"
+#include "AABBTree.h"
 
 namespace Raven {
 
+    /*
+     * A single narrowphase result. Contacts are stored by value in a buffer that is reused
+     * every tick, so detecting a collision never touches the heap.
+     */
+    struct Contact {
+
+        // The entity with the lower index in the colliding pair
+        ex::Entity::Id leftId;
+
+        // The entity with the higher index in the colliding pair
+        ex::Entity::Id rightId;
+
+        // The approximate point of impact, midway between the two colliders
+        sf::Vector2f point;
+
+        // How far the colliders overlap on each axis
+        sf::Vector2f penetration;
+
+        // The fraction of the tick at which the colliders first touched (1 for discrete contacts)
+        float timeOfImpact;
+
+        // Orders contacts by pair so that duplicates end up adjacent
+        bool operator < (const Contact &other) const {
+            return leftId.index() != other.leftId.index() ? leftId.index() < other.leftId.index() :
+                rightId.index() < other.rightId.index();
+        }
+
+        // Whether both contacts describe the same pair of entities
+        bool samePair(const Contact &other) const {
+            return leftId == other.leftId && rightId == other.rightId;
+        }
+    };
+
     class CollisionSystem : public ex::System<CollisionSystem>,
         public ex::Receiver<CollisionSystem> {
 
     public:
         /*
-         *
+         * Initializes the system with the given broadphase. The cell dimensions
+         * are only used by the SPATIAL_HASH broadphase.
          */
-        explicit CollisionSystem() {
-
-        }
+        explicit CollisionSystem(cmn::EBroadphase broadphaseType = cmn::EBroadphase::SPATIAL_HASH,
+            float cellWidth = cmn::STD_UNITX, float cellHeight = cmn::STD_UNITY);
 
         /*
          * Setup necessary static information
          */
         void configure(entityx::EventManager &event_manager) {
-            event_manager.subscribe<CollisionEvent>(*this);
+            event_manager.subscribe_batch<CollisionContactEvent>(*this);
+            event_manager.subscribe<CollisionBatchEvent>(*this);
+            event_manager.subscribe_batch<CollisionEvent>(*this);
+            event_manager.subscribe<XMLLevelLoadedEvent>(*this);
+            event_manager.subscribe<ex::ComponentRemovedEvent<BoxCollider>>(*this);
+            event_manager.subscribe<ex::EntityDestroyedEvent>(*this);
         }
 
         /*
-         * Iterate through all objects with Colliders and emit CollisionEvents.
+         * Iterate through all objects with Colliders and post a CollisionContactEvent per contact.
          */
         void update(ex::EntityManager &es, ex::EventManager &events,
             ex::TimeDelta dt) override;
 
-        // Picks up CollisionEvents
-        void receive(const CollisionEvent &event);
+        /*
+         * Hands the colliders' current bounds to the broadphase and the static tree without
+         * looking for contacts. update() starts with this; call it directly to keep the
+         * SpatialIndex's view of the colliders current while the simulation is paused.
+         */
+        void updateBounds(ex::EntityManager &es);
+
+        // The world-space bounds of an entity's BoxCollider at its Transform's position
+        static ColliderBounds getBounds(ex::Entity entity, const Transform &transform, const BoxCollider &collider);
+
+        /*
+         * Declares the components touched by update() for the SystemScheduler. The Rigidbodies
+         * are only read, as contacts are responded to when the queued events are dispatched.
+         */
+        void access(ex::ComponentAccess &access) const override;
+
+        // Resolves the components of a tick's posted contacts and emits them as one CollisionBatchEvent
+        void receive(const ex::EventSpan<CollisionContactEvent> &contacts);
+
+        // Picks up the contacts of a tick
+        void receive(const CollisionBatchEvent &event);
+
+        // Picks up individually emitted CollisionEvents
+        void receive(const ex::EventSpan<CollisionEvent> &events);
+
+        // Schedules a rebuild of the static tree for the newly loaded level
+        void receive(const XMLLevelLoadedEvent &event);
+
+        // Evicts a collider from the broadphase and the static tree once its BoxCollider is removed
+        void receive(const ex::ComponentRemovedEvent<BoxCollider> &event);
+
+        // Evicts a destroyed entity's collider, as destruction does not emit ComponentRemovedEvents
+        void receive(const ex::EntityDestroyedEvent &event);
 
         /*
          * Tests whether two entities' colliders register a collision.
+         * On a hit, fills in the contact and returns true.
+         */
+        bool testCollision(ex::Entity leftEntity, ex::Entity rightEntity, Contact &contact);
+
+        /*
+         * Tests whether a swept collider meets another collider at any point during the tick.
+         * On a hit, fills in the contact as of the time of impact and returns true.
+         */
+        static bool testSweptCollision(const ColliderBounds &left, const ColliderBounds &right, Contact &contact);
+
+        /*
+         * Spreads the pair search over the given number of worker threads (in addition to the
+         * calling thread). Zero, the default, keeps collision detection on the calling thread.
          */
-        std::shared_ptr<sf::Vector2f> CollisionSystem::testCollision(ex::Entity leftEntity,
-            ex::Entity rightEntity);
+        void setWorkerThreads(std::size_t threads);
+
+        std::size_t getWorkerThreads() const { return workers ? workers->size() : 0; }
+
+        // Below this many colliders, the pair search stays on the calling thread
+        static const std::size_t PARALLEL_THRESHOLD = 1024;
+
+        // The contacts detected during the most recent update, sorted by entity pair
+        const std::vector<Contact> &getContacts() const { return contacts; }
+
+        // The broadphase used to cull pairs of colliders that cannot possibly be touching
+        std::unique_ptr<Broadphase> broadphase;
+
+        // The hierarchy holding every fixed collider, queried only by dynamic colliders
+        const AABBTree &getStaticTree() const { return staticTree; }
 
     private:
-        std::map<ex::Entity, std::set<ex::Entity>> collisionMap;
+        // The unique contacts of the current tick (storage reused between ticks)
+        std::vector<Contact> contacts;
+
+        // The dispatched contacts with their components resolved (storage reused between ticks)
+        std::vector<CollisionRecord> records;
+
+        // Applies the collision response for a single pair
+        void respond(ex::ComponentHandle<Rigidbody> leftRigidbody,
+            ex::ComponentHandle<BoxCollider> leftBoxCollider, ex::ComponentHandle<Rigidbody> rightRigidbody,
+            ex::ComponentHandle<BoxCollider> rightBoxCollider);
+
+        // The bounds of every dynamic collider for the current tick (storage reused between ticks)
+        std::vector<ColliderBounds> colliderBounds;
+
+        // The bounds of every fixed collider for the current tick (storage reused between ticks)
+        std::vector<ColliderBounds> fixedBounds;
+
+        // The hierarchy holding every fixed collider
+        AABBTree staticTree;
+
+        // Whether the static tree must be rebuilt from scratch, e.g. after a level load
+        bool staticTreeDirty;
+
+        // Brings the static tree in line with fixedBounds
+        void updateStaticTree();
+
+        // Maps an entity index to the index of its bounds in colliderBounds
+        std::vector<std::uint32_t> boundsByEntity;
+
+        // The earliest time of impact of each swept collider, indexed like colliderBounds
+        std::vector<float> earliestImpact;
+
+        // Moves swept colliders that hit something back to where they first made contact
+        void rewindSweptColliders();
+
+        // The thread-local buffers of one partition of the pair search (storage reused between ticks)
+        struct Partition {
+            // The candidate pairs produced by the broadphase
+            std::vector<Broadphase::EntityPair> pairs;
+
+            // The pairs packed into the narrowphase batch, lower entity index first
+            std::vector<Broadphase::EntityPair> packedPairs;
+
+            // The candidate pairs packed for the SIMD overlap test
+            NarrowphaseBatch narrowphase;
+
+            // One bit per packed pair, set when the pair overlaps
+            std::vector<std::uint32_t> hits;
+
+            // The contacts found in this partition
+            std::vector<Contact> contacts;
+        };
+
+        // Runs the broadphase search and the narrowphase for one partition. Safe to call concurrently.
+        void detect(Partition &partition, std::size_t index, std::size_t count) const;
+
+        // One entry per partition of the current tick's pair search
+        std::vector<Partition> partitions;
+
+        // The worker threads used for the pair search, if any
+        std::unique_ptr<ex::help::ThreadPool> workers;
     };
 
 }
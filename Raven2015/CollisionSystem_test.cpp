@@ -0,0 +1,141 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include <vector>                       // For std::vector
+#include "entityx\3rdparty\catch.hpp"   // For TEST_CASE, REQUIRE
+#include "CollisionSystem.h"
+#include "ComponentLibrary.h"           // For Transform, Rigidbody, BoxCollider
+#include "EventLibrary.h"               // For CollisionBatchEvent, CollisionRecord
+
+using namespace Raven;
+
+TEST_CASE("TestSweptColliderStopsAtFixedColliderCreatedAfterIt") {
+    ex::EventManager events;
+    ex::EntityManager entities(events);
+    CollisionSystem system;
+
+    // The mover ends the tick at x = 100, having passed straight through the wall from x = 0
+    ex::Entity mover = entities.create();
+    mover.assign<Transform>(100.0f, 0.0f);
+    mover.assign<Rigidbody>(100.0f, 0.0f);
+    mover.assign<BoxCollider>(10.0f, 10.0f, 0.0f, 0.0f)->collisionSettings =
+        cmn::CollisionInformation::SOLID | cmn::CollisionInformation::CONTINUOUS;
+
+    // Created last, so that its index lies beyond that of every dynamic collider
+    ex::Entity wall = entities.create();
+    wall.assign<Transform>(50.0f, 0.0f);
+    wall.assign<BoxCollider>(2.0f, 100.0f, 0.0f, 0.0f)->collisionSettings =
+        cmn::CollisionInformation::SOLID | cmn::CollisionInformation::FIXED;
+
+    system.update(entities, events, 0.0);
+
+    REQUIRE(system.getContacts().size() == 1);
+    REQUIRE(system.getContacts()[0].timeOfImpact < 1.0f);
+
+    // Rewound to where its right edge (x + 5) first met the wall's left edge (49)
+    REQUIRE(mover.component<Transform>()->transform.x == Approx(44.0f));
+    REQUIRE(wall.component<Transform>()->transform.x == Approx(50.0f));
+}
+
+TEST_CASE("TestContinuousColliderWithoutRigidbodyIsNotSwept") {
+    ex::EventManager events;
+    ex::EntityManager entities(events);
+    CollisionSystem system;
+
+    // Marked continuous but given no Rigidbody, so there is no velocity to sweep along
+    ex::Entity mover = entities.create();
+    mover.assign<Transform>(100.0f, 0.0f);
+    mover.assign<BoxCollider>(10.0f, 10.0f, 0.0f, 0.0f)->collisionSettings =
+        cmn::CollisionInformation::SOLID | cmn::CollisionInformation::CONTINUOUS;
+
+    ex::Entity wall = entities.create();
+    wall.assign<Transform>(50.0f, 0.0f);
+    wall.assign<BoxCollider>(2.0f, 100.0f, 0.0f, 0.0f)->collisionSettings =
+        cmn::CollisionInformation::SOLID | cmn::CollisionInformation::FIXED;
+
+    system.update(entities, events, 0.0);
+
+    REQUIRE(system.getContacts().empty());
+    REQUIRE(mover.component<Transform>()->transform.x == Approx(100.0f));
+}
+
+namespace {
+    // Keeps what the CollisionSystem's batch carried, since its records only live for the emit
+    struct BatchRecorder : public ex::Receiver<BatchRecorder> {
+        void receive(const CollisionBatchEvent &event) {
+            ++batches;
+            records.assign(event.begin(), event.end());
+        }
+
+        int batches = 0;
+        std::vector<CollisionRecord> records;
+    };
+}
+
+TEST_CASE("TestContactsArriveAsOneBatchWithResolvedComponents") {
+    ex::EventManager events;
+    ex::EntityManager entities(events);
+    CollisionSystem system;
+    system.configure(events);
+    BatchRecorder recorder;
+    events.subscribe<CollisionBatchEvent>(recorder);
+
+    // Two separate overlapping pairs
+    ex::Entity entitiesByPair[2][2];
+    for (int pair = 0; pair < 2; ++pair) {
+        for (int side = 0; side < 2; ++side) {
+            ex::Entity entity = entities.create();
+            entity.assign<Transform>(pair * 1000.0f + side * 5.0f, 0.0f);
+            entity.assign<Rigidbody>();
+            entity.assign<BoxCollider>(10.0f, 10.0f, 0.0f, 0.0f)->collisionSettings = cmn::CollisionInformation::SOLID;
+            entitiesByPair[pair][side] = entity;
+        }
+    }
+
+    // Nothing is delivered until the frame dispatches its events
+    system.update(entities, events, 0.0);
+    REQUIRE(recorder.batches == 0);
+    events.dispatch_all();
+
+    REQUIRE(recorder.batches == 1);
+    REQUIRE(recorder.records.size() == 2);
+    for (CollisionRecord record : recorder.records) {
+        REQUIRE(record.leftBoxCollider.get() == record.leftEntity.component<BoxCollider>().get());
+        REQUIRE(record.rightRigidbody.get() == record.rightEntity.component<Rigidbody>().get());
+        REQUIRE(record.leftTransform);
+        REQUIRE(record.rightTransform);
+    }
+}
+
+TEST_CASE("TestContactOfDestroyedEntityIsDropped") {
+    ex::EventManager events;
+    ex::EntityManager entities(events);
+    CollisionSystem system;
+    system.configure(events);
+    BatchRecorder recorder;
+    events.subscribe<CollisionBatchEvent>(recorder);
+
+    ex::Entity left = entities.create();
+    left.assign<Transform>(0.0f, 0.0f);
+    left.assign<Rigidbody>();
+    left.assign<BoxCollider>(10.0f, 10.0f, 0.0f, 0.0f)->collisionSettings = cmn::CollisionInformation::SOLID;
+    ex::Entity right = entities.create();
+    right.assign<Transform>(5.0f, 0.0f);
+    right.assign<Rigidbody>();
+    right.assign<BoxCollider>(10.0f, 10.0f, 0.0f, 0.0f)->collisionSettings = cmn::CollisionInformation::SOLID;
+
+    // Destroyed between the contact being posted and the events being dispatched
+    system.update(entities, events, 0.0);
+    right.destroy();
+    events.dispatch_all();
+
+    REQUIRE(recorder.batches == 0);
+}
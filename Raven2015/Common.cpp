@@ -4,7 +4,60 @@ namespace Raven {
 
     namespace Common {
 
-        const std::set<std::string> CollisionInformation::settings({ "Solid", "Fixed" });
+        const std::set<std::string> CollisionInformation::settings({ COLLISION_LAYER_SETTINGS_SOLID,
+            COLLISION_LAYER_SETTINGS_FIXED, COLLISION_LAYER_SETTINGS_CONTINUOUS });
+
+        std::vector<std::string> CollisionInformation::layerNames({ "Default" });
+
+        std::vector<CollisionMask> CollisionInformation::layerMatrix(CollisionInformation::MAX_LAYERS, ~CollisionMask(0));
+
+        CollisionMask CollisionInformation::getSettingBit(const std::string &settingName) {
+            if (settingName == COLLISION_LAYER_SETTINGS_SOLID) return SOLID;
+            if (settingName == COLLISION_LAYER_SETTINGS_FIXED) return FIXED;
+            if (settingName == COLLISION_LAYER_SETTINGS_CONTINUOUS) return CONTINUOUS;
+            return NO_SETTINGS;
+        }
+
+        CollisionMask CollisionInformation::getLayerBit(const std::string &layerName) {
+            for (std::size_t i = 0; i < layerNames.size(); ++i) {
+                if (layerNames[i] == layerName) {
+                    return CollisionMask(1) << i;
+                }
+            }
+            if (layerNames.size() >= MAX_LAYERS) {
+                cerr << "Warning: Collision layer \"" + layerName + "\" ignored. All collision layers are in use." << endl;
+                return 0;
+            }
+            layerNames.push_back(layerName);
+            return CollisionMask(1) << (layerNames.size() - 1);
+        }
+
+        std::string CollisionInformation::getLayerName(std::size_t layerIndex) {
+            return layerIndex < layerNames.size() ? layerNames[layerIndex] : "";
+        }
+
+        void CollisionInformation::setLayersCollide(const std::string &layerA, const std::string &layerB, bool collide) {
+            CollisionMask bitA = getLayerBit(layerA), bitB = getLayerBit(layerB);
+            if (!bitA || !bitB) {
+                return;
+            }
+            for (std::size_t i = 0; i < MAX_LAYERS; ++i) {
+                CollisionMask bit = CollisionMask(1) << i;
+                // Keep the matrix symmetric so that testing a single direction is sufficient
+                if (bit == bitA) layerMatrix[i] = collide ? (layerMatrix[i] | bitB) : (layerMatrix[i] & ~bitB);
+                if (bit == bitB) layerMatrix[i] = collide ? (layerMatrix[i] | bitA) : (layerMatrix[i] & ~bitA);
+            }
+        }
+
+        CollisionMask CollisionInformation::getCollidingLayers(CollisionMask layers) {
+            CollisionMask colliding = 0;
+            for (std::size_t i = 0; layers; ++i, layers >>= 1) {
+                if (layers & 1) {
+                    colliding |= layerMatrix[i];
+                }
+            }
+            return colliding;
+        }
 
         extern ex::EntityManager* entities = nullptr;
         extern ex::EventManager* events = nullptr;
@@ -6,6 +6,7 @@
 #define FPS_30_TICK_TIME 0.0333333333333f
 #define FPS_60_TICK_TIME 0.0166666666666f
 #define FPS_100_TICK_TIME 0.0100000000000f
+#define MAX_CATCH_UP_STEPS 5
 #define SOUNDMAP_T std::map<std::string, std::shared_ptr<sf::SoundBuffer>>
 #define MUSICMAP_T std::map<std::string, std::shared_ptr<sf::Music>>
 #define NO_ACTION_STR "NO ACTION"
@@ -17,8 +18,11 @@
 // CollisionLayerSettings
 #define COLLISION_LAYER_SETTINGS_SOLID "Solid"
 #define COLLISION_LAYER_SETTINGS_FIXED "Fixed"
+#define COLLISION_LAYER_SETTINGS_CONTINUOUS "Continuous"
 
+#include <cstdint>
 #include <iostream>
+#include <vector>
 #include "entityx\config.h"
 #include "tinyxml2.h"
 #include "entityx/Entity.h"
@@ -53,6 +57,14 @@ namespace Raven {
         // A specification of the ELoop type for audio resources only
         typedef ELoop EAudioLoop;
 
+        /*
+         * An enumeration type detailing the broadphase algorithms available to the CollisionSystem.
+         * SPATIAL_HASH     = Uniform grid rebuilt every tick. Best for evenly sized, evenly spread colliders
+         * SWEEP_AND_PRUNE  = Persistent sorted x-extents. Best when colliders move little per tick
+         * AABB_TREE        = Incremental tree with fattened leaves. Best for colliders of very mixed sizes
+         */
+        enum EBroadphase { SPATIAL_HASH, SWEEP_AND_PRUNE, AABB_TREE };
+
         /* 
          * An enumeration type detailing a set of macro render-sorting layers.
          * NO_LAYER     = "null" value
@@ -120,10 +132,45 @@ namespace Raven {
         const float CANVAS_WIDTH = 600;
         const float CANVAS_HEIGHT = 400;
 
+        // A bitfield of collision layers or collision settings
+        typedef std::uint32_t CollisionMask;
+
         struct CollisionInformation {
 
+            // The names of every valid collision setting, as they appear in XML
             static const std::set<std::string> settings;
 
+            // Bit flags for the BoxCollider::collisionSettings bitfield
+            enum ESetting : CollisionMask { NO_SETTINGS = 0, SOLID = 1 << 0, FIXED = 1 << 1, CONTINUOUS = 1 << 2 };
+
+            // The maximum number of distinct collision layers (one per bit of a CollisionMask)
+            static const std::size_t MAX_LAYERS = 32;
+
+            // The layer assigned to colliders that do not name any layers
+            static const CollisionMask DEFAULT_LAYER = 1;
+
+            // Maps a setting name (e.g. "Solid") to its bit flag. Unknown names map to NO_SETTINGS.
+            static CollisionMask getSettingBit(const std::string &settingName);
+
+            // Maps a layer name to its bit, registering the name if it has not been seen before.
+            // Returns 0 (and prints a warning) once all MAX_LAYERS bits are in use.
+            static CollisionMask getLayerBit(const std::string &layerName);
+
+            // Acquires the name registered for the layer at the given bit index
+            static std::string getLayerName(std::size_t layerIndex);
+
+            // Sets whether colliders on the two named layers may collide. Every pair of layers collides by default.
+            static void setLayersCollide(const std::string &layerA, const std::string &layerB, bool collide);
+
+            // The union of every layer that may collide with at least one of the given layers
+            static CollisionMask getCollidingLayers(CollisionMask layers);
+
+        private:
+            // The registered layer names, indexed by bit
+            static std::vector<std::string> layerNames;
+
+            // The global layer-vs-layer collision matrix. Row i holds the layers that layer i collides with.
+            static std::vector<CollisionMask> layerMatrix;
         };
 
         extern Game* game;
@@ -207,6 +207,7 @@ namespace Raven {
         t->FirstChildElement("TransformX")->QueryFloatText(&(this->transform.x));
         t->FirstChildElement("TransformY")->QueryFloatText(&this->transform.y);
         node->FirstChildElement("Rotation")->QueryFloatText(&this->rotation);
+        previousTransform = transform;
         }
 
     Box::Ptr Transform::createWidget() {
@@ -231,6 +232,7 @@ namespace Raven {
         if (b) transform.y = std::stof(s);
         b &= (s = getEntryValue(box, 2)).size() ? true : false;
         if (b) rotation = std::stof(s);
+        previousTransform = transform;
         return b;
         }
 
@@ -294,12 +296,18 @@ namespace Raven {
 
     std::string BoxCollider::serialize(std::string tab) {
         std::string layersContent = "";
-            for (std::string layer : layers) {
-                layersContent +=
-                tab + "    <Layer>" + layer + "</Layer>\r\n";
+        // Colliders left on the default layer keep an empty <Layers/> element
+        if (layers != cmn::CollisionInformation::DEFAULT_LAYER) {
+            for (std::size_t i = 0; i < cmn::CollisionInformation::MAX_LAYERS; ++i) {
+                if (layers & (cmn::CollisionMask(1) << i)) {
+                    layersContent +=
+                    tab + "    <Layer>" + cmn::CollisionInformation::getLayerName(i) + "</Layer>\r\n";
+                }
             }
-        bool solid = collisionSettings.find("Solid") != collisionSettings.end();
-        bool fixed = collisionSettings.find("Fixed") != collisionSettings.end();
+        }
+        bool solid = hasSetting(cmn::CollisionInformation::SOLID);
+        bool fixed = hasSetting(cmn::CollisionInformation::FIXED);
+        bool continuous = hasSetting(cmn::CollisionInformation::CONTINUOUS);
 
             return
             tab + "<BoxCollider>\r\n" +
@@ -313,6 +321,7 @@ namespace Raven {
             tab + "  <Settings>\r\n" +
             tab + "    <Solid>" + std::to_string(solid) + "</Solid>\r\n" +
             tab + "    <Fixed>" + std::to_string(fixed) + "</Fixed>\r\n" +
+            tab + "    <Continuous>" + std::to_string(continuous) + "</Continuous>\r\n" +
             tab + "  </Settings>\r\n" +
             tab + "</BoxCollider>\r\n";
         }
@@ -323,21 +332,30 @@ namespace Raven {
         node->FirstChildElement("XOffset")->QueryFloatText(&this->originOffset.x);
         node->FirstChildElement("YOffset")->QueryFloatText(&this->originOffset.y);
 
-        XMLElement* t = node->FirstChildElement("Layer");
-            layers.clear();
+        // Layer names are mapped onto bits here so that the XML stays human-readable
+        XMLElement* t = node->FirstChildElement("Layers");
+        t = t ? t->FirstChildElement("Layer") : nullptr;
+        layers = 0;
         while (t) {
-                layers.insert(t->GetText());
+            if (t->GetText()) {
+                layers |= cmn::CollisionInformation::getLayerBit(t->GetText());
+            }
             t = t->NextSiblingElement("Layer");
-        } 
+        }
+        if (!layers) {
+            layers = cmn::CollisionInformation::DEFAULT_LAYER;
+        }
 
         t = node->FirstChildElement("Settings");
-            collisionSettings.clear();
-            for (std::string setting : cmn::CollisionInformation::settings) {
-                bool val;
-                t->FirstChildElement(setting.c_str())->QueryBoolText(&val);
-            if (val) collisionSettings.insert("" + setting);
-            }
+        collisionSettings = cmn::CollisionInformation::NO_SETTINGS;
+        for (std::string setting : cmn::CollisionInformation::settings) {
+            bool val = false;
+            // Settings added after a level was saved are simply absent from its XML
+            XMLElement* settingElement = t->FirstChildElement(setting.c_str());
+            if (settingElement) settingElement->QueryBoolText(&val);
+            if (val) collisionSettings |= cmn::CollisionInformation::getSettingBit(setting);
         }
+    }
 
     Box::Ptr BoxCollider::createWidget() {
         Box::Ptr box = ED_ASSET_WIDGET_LIST::Create();
@@ -346,14 +364,18 @@ namespace Raven {
         initEditableAssetListItem(widthBox, std::to_string(width).c_str());
         Box::Ptr heightBox = ED_ASSET_WIDGET_LIST::appendWidget(box, "Height", componentFormatter);
         initEditableAssetListItem(heightBox, std::to_string(height).c_str());
-        for (auto layer : layers) {
-            Box::Ptr layerBox = ED_ASSET_WIDGET_LIST::appendWidget(box, "Collision Layer", componentFormatter);
-            initEditableAssetListItem(layerBox, layer.c_str());
+        for (std::size_t i = 0; i < cmn::CollisionInformation::MAX_LAYERS; ++i) {
+            if (layers & (cmn::CollisionMask(1) << i)) {
+                Box::Ptr layerBox = ED_ASSET_WIDGET_LIST::appendWidget(box, "Collision Layer", componentFormatter);
+                initEditableAssetListItem(layerBox, cmn::CollisionInformation::getLayerName(i).c_str());
             }
+        }
         Box::Ptr solidBox = ED_ASSET_WIDGET_LIST::appendWidget(box, COLLISION_LAYER_SETTINGS_SOLID, componentFormatter);
-        initEditableAssetListItem(solidBox, COLLISION_LAYER_SETTINGS_SOLID);
+        initEditableAssetListItem(solidBox, std::to_string(hasSetting(cmn::CollisionInformation::SOLID)).c_str());
         Box::Ptr fixedBox = ED_ASSET_WIDGET_LIST::appendWidget(box, COLLISION_LAYER_SETTINGS_FIXED, componentFormatter);
-        initEditableAssetListItem(fixedBox, COLLISION_LAYER_SETTINGS_FIXED);
+        initEditableAssetListItem(fixedBox, std::to_string(hasSetting(cmn::CollisionInformation::FIXED)).c_str());
+        Box::Ptr continuousBox = ED_ASSET_WIDGET_LIST::appendWidget(box, COLLISION_LAYER_SETTINGS_CONTINUOUS, componentFormatter);
+        initEditableAssetListItem(continuousBox, std::to_string(hasSetting(cmn::CollisionInformation::CONTINUOUS)).c_str());
 
         return box;
         }
@@ -367,16 +389,28 @@ namespace Raven {
         if (b) height = std::stof(s);
         b &= (s = getHiddenData(box, 2)).size() ? true : false;
         int numLayers = b ? stoi(s) : b;
+        cmn::CollisionMask newLayers = 0;
         for (int i = 0; i < numLayers; ++i) {
             b &= (s = getEntryValue(box, 2 + i)).size() ? true : false;
-    }
+            if (b) newLayers |= cmn::CollisionInformation::getLayerBit(s);
+        }
+        if (b && newLayers) {
+            layers = newLayers;
+        }
         b &= (s = getEntryValue(box, 2 + numLayers)).size() ? true : false;
-        if (b && stoi(s)) {
-            collisionSettings.insert(COLLISION_LAYER_SETTINGS_SOLID);
+        if (b) {
+            collisionSettings = stoi(s) ? (collisionSettings | cmn::CollisionInformation::SOLID) :
+                (collisionSettings & ~cmn::CollisionMask(cmn::CollisionInformation::SOLID));
         }
         b &= (s = getEntryValue(box, 3 + numLayers)).size() ? true : false;
-        if (b && stoi(s)) {
-            collisionSettings.insert(COLLISION_LAYER_SETTINGS_FIXED);
+        if (b) {
+            collisionSettings = stoi(s) ? (collisionSettings | cmn::CollisionInformation::FIXED) :
+                (collisionSettings & ~cmn::CollisionMask(cmn::CollisionInformation::FIXED));
+        }
+        b &= (s = getEntryValue(box, 4 + numLayers)).size() ? true : false;
+        if (b) {
+            collisionSettings = stoi(s) ? (collisionSettings | cmn::CollisionInformation::CONTINUOUS) :
+                (collisionSettings & ~cmn::CollisionMask(cmn::CollisionInformation::CONTINUOUS));
         }
         return b;
     }
@@ -99,14 +99,20 @@ namespace Raven {
 
             transform.x = transformX;
             transform.y = transformY;
+            previousTransform = transform;
         }
 
         // Copy Constructor
-        Transform(const Transform& other) : transform(other.transform), rotation(other.rotation) {}
+        Transform(const Transform& other) : transform(other.transform),
+            previousTransform(other.previousTransform), rotation(other.rotation) {}
 
         // The x and y coordinates of the entity's Origin.
         sf::Vector2f transform;
 
+        // The coordinates of the entity's Origin at the start of the latest simulation step.
+        // Rendering interpolates from here towards transform. Not serialized.
+        sf::Vector2f previousTransform;
+
         // The orientation of the entity, measured in degrees.
         // Assumes that 0 begins at the right, running counterclockwise.
         float rotation;
@@ -173,7 +179,8 @@ namespace Raven {
         BoxCollider(const float width = cmn::STD_UNITX,
             const float height = cmn::STD_UNITY,
             const float x = 0.0f, const float y = 0.0f)
-            : width(width), height(height) {
+            : width(width), height(height), layers(cmn::CollisionInformation::DEFAULT_LAYER),
+            collisionSettings(cmn::CollisionInformation::NO_SETTINGS) {
 
             originOffset.x = x;
             originOffset.y = y;
@@ -200,14 +207,21 @@ namespace Raven {
         // The range of the y-axis of the collider. Origin in the middle.
         float height;
         
-        // The set of layers to which the collider is assigned. 
-        // The collider will "collide" with any BoxCollider that possesses the same entry.
-        std::set<std::string> layers;
+        // The set of layers to which the collider is assigned, one bit per layer name registered
+        // in Common::CollisionInformation. The collider will "collide" with any BoxCollider
+        // on a layer that the global layer matrix pairs with one of its own.
+        cmn::CollisionMask layers;
         
-        // The collision settings. Valid values can be found in Common::CollisionLayerSettings
+        // The collision settings, as Common::CollisionInformation::ESetting flags
         // SOLID : The layer that indicates the entities should be "pushed out of each other"
         // FIXED : The layer that indicates the entity will react to the collision
-        std::set<std::string> collisionSettings;
+        // CONTINUOUS : Fast movers are swept along their velocity so they cannot tunnel through thin colliders
+        cmn::CollisionMask collisionSettings;
+
+        // Whether the given Common::CollisionInformation::ESetting flag is set
+        bool hasSetting(cmn::CollisionMask setting) const {
+            return (collisionSettings & setting) != 0;
+        }
     
         ADD_COMPONENT_DEFAULTS(BoxCollider);
     };
@@ -419,3 +433,14 @@ namespace Raven {
 #pragma endregion
 
 }
+
+// Levels hold only a handful of these, so their storage is allocated a few at a time rather than
+// in 64KB chunks.
+namespace entityx {
+    template <> struct ComponentStorageTraits<Raven::SoundMaker> { static const std::size_t chunk_size = 16; };
+    template <> struct ComponentStorageTraits<Raven::MusicMaker> { static const std::size_t chunk_size = 16; };
+    template <> struct ComponentStorageTraits<Raven::Pawn> { static const std::size_t chunk_size = 16; };
+    template <> struct ComponentStorageTraits<Raven::Villain> { static const std::size_t chunk_size = 16; };
+    template <> struct ComponentStorageTraits<Raven::Tracker> { static const std::size_t chunk_size = 16; };
+    template <> struct ComponentStorageTraits<Raven::Pacer> { static const std::size_t chunk_size = 16; };
+}
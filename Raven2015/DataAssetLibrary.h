@@ -17,6 +17,7 @@ namespace Raven {
      // A wrapper class around drawable assets to allow for sorting.
      // Sorting is based on layer first, priority second.
      // A low priority means it will be drawn first, i.e. below other objects
+     // RenderingSystem orders them with a RenderList, which breaks ties by texture, then entity
     struct Renderable {
 
         Renderable(const float offsetX = 0.f, const float offsetY = 0.f, 
@@ -221,7 +222,7 @@ namespace Raven {
                 textureFileName(other.textureFileName), 
                 frameWidth(other.frameWidth), frameHeight(other.frameHeight), 
                 size(other.size), isLooping(other.isLooping), 
-                animationSpeed(other.animationSpeed) {
+                animationSpeed(other.animationSpeed), origin(other.origin) {
 
             init();
         }
@@ -250,6 +251,9 @@ namespace Raven {
         // The name of the texture file referenced by the animation (the spritesheet, single line)        
         std::string textureFileName;
 
+        // The top-left corner of the spritesheet within the texture drawn from (its TextureAtlas page)
+        sf::Vector2i origin;
+
         // Initializes frames
         void init() {
             // Ensure that we have one viewing rectangle (sf::IntRect) into the texture for each sprite frame
@@ -259,10 +263,17 @@ namespace Raven {
             for (int i = 0; i < frames.size(); ++i) {
                 frames[i].width = frameWidth;
                 frames[i].height = frameHeight;
-                frames[i].left += i*frameWidth;
+                frames[i].left = origin.x + i*frameWidth;
+                frames[i].top = origin.y;
             }
         }
 
+        // Moves the frames onto the spritesheet's region of a TextureAtlas page
+        void placeInAtlas(const sf::IntRect& region) {
+            origin = sf::Vector2i(region.left, region.top);
+            init();
+        }
+
         ADD_DATA_ASSET_DEFAULTS
     };
 
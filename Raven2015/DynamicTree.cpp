@@ -0,0 +1,73 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include "DynamicTree.h"
+#include <algorithm>            // For std::sort, std::binary_search
+
+using namespace Raven;
+
+void DynamicTree::update(const std::vector<ColliderBounds> &bounds) {
+    current = bounds;
+    for (const ColliderBounds &b : current) {
+        tree.move(b);
+    }
+
+    // Removals normally arrive through colliderRemoved(). A collider can still vanish from the
+    // list without losing its BoxCollider (e.g. by becoming Fixed), so sweep up any leftovers.
+    if (tree.size() != current.size()) {
+        currentIds.clear();
+        for (const ColliderBounds &b : current) {
+            currentIds.push_back(b.entity.id().id());
+        }
+        std::sort(currentIds.begin(), currentIds.end());
+
+        std::vector<ex::Entity::Id> stale;
+        tree.forEach([&](const ColliderBounds &b) {
+            if (!std::binary_search(currentIds.begin(), currentIds.end(), b.entity.id().id())) {
+                stale.push_back(b.entity.id());
+            }
+        });
+        for (ex::Entity::Id id : stale) {
+            tree.remove(id);
+        }
+    }
+}
+
+/*
+ * Every collider looks for overlapping colliders with a higher entity index, so each pair is
+ * reported once, by its lower-indexed collider. The leaves are fat, so the exact bounds of
+ * the colliders are compared before a pair is reported.
+ */
+void DynamicTree::findPairs(std::vector<EntityPair> &pairs, std::size_t partition,
+    std::size_t partitionCount) const {
+
+    for (std::size_t i = partition; i < current.size(); i += partitionCount) {
+        const ColliderBounds &self = current[i];
+        tree.query(self.left, self.top, self.right, self.bottom, [&](const ColliderBounds &other) {
+            if (self.entity.id().index() < other.entity.id().index() &&
+                self.canCollide(other) && self.overlaps(other)) {
+                pairs.push_back(std::make_pair(self.entity, other.entity));
+            }
+        });
+    }
+}
+
+void DynamicTree::queryBounds(float left, float top, float right, float bottom, QueryVisitor &visitor) const {
+    tree.query(left, top, right, bottom, [&](const ColliderBounds &b) {
+        if (b.left <= right && left <= b.right && b.top <= bottom && top <= b.bottom) {
+            visitor.visit(b);
+        }
+    });
+}
+
+void DynamicTree::colliderRemoved(ex::Entity::Id id) {
+    tree.remove(id);
+}
@@ -0,0 +1,60 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include "Broadphase.h"         // For Broadphase, ColliderBounds
+#include "AABBTree.h"           // For AABBTree
+
+namespace Raven {
+
+    /*
+     * A broadphase over an incrementally updated AABB tree with fattened leaves. Unlike a
+     * uniform grid, it copes with worlds that mix tiny colliders with very large ones.
+     * Colliders enter the tree with their first update and leave it as soon as the
+     * CollisionSystem reports that their BoxCollider or entity is gone.
+     */
+    class DynamicTree : public Broadphase {
+    public:
+        // Initializes the tree with leaves enlarged by the given margin, in pixels
+        explicit DynamicTree(float margin = cmn::STD_UNITX * 0.25f) : tree(margin) {}
+
+        // Moves every collider within the tree, re-inserting only those that left their fat box
+        void update(const std::vector<ColliderBounds> &bounds) override;
+
+        using Broadphase::findPairs;
+
+        // Queries the tree with every collider assigned to the partition
+        void findPairs(std::vector<EntityPair> &pairs, std::size_t partition,
+            std::size_t partitionCount) const override;
+
+        // Drops the collider from the tree
+        void colliderRemoved(ex::Entity::Id id) override;
+
+        std::size_t size() const override { return tree.size(); }
+
+        const AABBTree &getTree() const { return tree; }
+
+    protected:
+        // Walks the tree, skipping colliders whose fattened box touches the area but whose bounds do not
+        void queryBounds(float left, float top, float right, float bottom, QueryVisitor &visitor) const override;
+
+    private:
+        AABBTree tree;
+
+        // The colliders of the current tick, in the order they were handed over
+        std::vector<ColliderBounds> current;
+
+        // Scratch storage for the IDs of this tick's colliders, used when cleaning up the tree
+        std::vector<std::uint64_t> currentIds;
+    };
+
+}
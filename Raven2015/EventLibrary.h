@@ -49,10 +49,12 @@ namespace Raven {
 
     /*
      * An event that stores the identities of two colliding entities.
+     * It resolves their components on construction, so it suits one-off emits;
+     * the CollisionSystem reports the contacts of a tick as a CollisionBatchEvent.
      */
     struct CollisionEvent : public ex::Event<CollisionEvent> {
 
-        CollisionEvent() : events(nullptr) {
+        CollisionEvent() : timeOfImpact(1.0f), events(nullptr) {
 
         }
 
@@ -64,9 +66,12 @@ namespace Raven {
         CollisionEvent(ex::Entity leftEntity,
             ex::Entity rightEntity,
             sf::Vector2f collisionPoint,
-            ex::EventManager *events = nullptr)
+            ex::EventManager *events = nullptr,
+            sf::Vector2f penetration = sf::Vector2f(),
+            float timeOfImpact = 1.0f)
             : leftEntity(leftEntity), rightEntity(rightEntity),
-            collisionPoint(collisionPoint), events(events) {
+            collisionPoint(collisionPoint), penetration(penetration),
+            timeOfImpact(timeOfImpact), events(events) {
 
             leftTransform = leftEntity.component<Transform>();
             leftRigidbody = leftEntity.component<Rigidbody>();
@@ -103,6 +108,102 @@ namespace Raven {
         // The point of impact between the two colliding entities.
         sf::Vector2f collisionPoint;
 
+        // How far the colliders overlap on each axis.
+        sf::Vector2f penetration;
+
+        // The fraction of the tick at which the colliders first touched (1 for discrete contacts).
+        float timeOfImpact;
+
+        ex::EventManager *events;
+    };
+
+    /*
+     * One contact of a tick, posted by the CollisionSystem from within its update. It carries
+     * no component handles, so posting it stays cheap; the CollisionSystem resolves them once
+     * per contact when the frame dispatches its events, and emits the result as a CollisionBatchEvent.
+     */
+    struct CollisionContactEvent : public ex::Event<CollisionContactEvent> {
+
+        CollisionContactEvent(ex::Entity leftEntity = ex::Entity(), ex::Entity rightEntity = ex::Entity(),
+            sf::Vector2f collisionPoint = sf::Vector2f(), sf::Vector2f penetration = sf::Vector2f(),
+            float timeOfImpact = 1.0f, ex::EventManager *events = nullptr)
+            : leftEntity(leftEntity), rightEntity(rightEntity), collisionPoint(collisionPoint),
+            penetration(penetration), timeOfImpact(timeOfImpact), events(events) {}
+
+        // The colliding left entity (the one with the lower index)
+        ex::Entity leftEntity;
+
+        // The colliding right entity
+        ex::Entity rightEntity;
+
+        // The point of impact between the two colliding entities.
+        sf::Vector2f collisionPoint;
+
+        // How far the colliders overlap on each axis.
+        sf::Vector2f penetration;
+
+        // The fraction of the tick at which the colliders first touched (1 for discrete contacts).
+        float timeOfImpact;
+
+        // The manager the CollisionBatchEvent is emitted through
+        ex::EventManager *events;
+    };
+
+    /*
+     * One contact of a CollisionBatchEvent. The component handles are resolved
+     * once by the CollisionSystem when the record is built.
+     */
+    struct CollisionRecord {
+
+        // The colliding left entity (the one with the lower index)
+        ex::Entity leftEntity;
+
+        // The colliding right entity
+        ex::Entity rightEntity;
+
+        // The components of the "left" entity in the collision.
+        ex::ComponentHandle<Transform> leftTransform;
+        ex::ComponentHandle<Rigidbody> leftRigidbody;
+        ex::ComponentHandle<BoxCollider> leftBoxCollider;
+
+        // The components of the "right" entity in the collision.
+        ex::ComponentHandle<Transform> rightTransform;
+        ex::ComponentHandle<Rigidbody> rightRigidbody;
+        ex::ComponentHandle<BoxCollider> rightBoxCollider;
+
+        // The point of impact between the two colliding entities.
+        sf::Vector2f collisionPoint;
+
+        // How far the colliders overlap on each axis.
+        sf::Vector2f penetration;
+
+        // The fraction of the tick at which the colliders first touched (1 for discrete contacts).
+        float timeOfImpact;
+    };
+
+    /*
+     * Delivers every collision of a tick at once as a contiguous span of records.
+     * The records are owned by the CollisionSystem and are only valid while the
+     * event is being received.
+     */
+    struct CollisionBatchEvent : public ex::Event<CollisionBatchEvent> {
+
+        CollisionBatchEvent(const CollisionRecord *records = nullptr, std::size_t count = 0,
+            ex::EventManager *events = nullptr)
+            : records(records), count(count), events(events) {}
+
+        const CollisionRecord *begin() const { return records; }
+        const CollisionRecord *end() const { return records + count; }
+        std::size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const CollisionRecord &operator[](std::size_t i) const { return records[i]; }
+
+        // The first record of the span
+        const CollisionRecord *records;
+
+        // The number of records in the span
+        std::size_t count;
+
         ex::EventManager *events;
     };
 
@@ -205,6 +306,13 @@ namespace Raven {
         XMLSaveEvent() {}
     };
 
+    // Emitted once every entity of a level has been deserialized
+    struct XMLLevelLoadedEvent : public ex::Event<XMLLevelLoadedEvent> {
+        XMLLevelLoadedEvent(std::string levelFilePath = "") : levelFilePath(levelFilePath) {}
+
+        std::string levelFilePath;
+    };
+
     struct XMLUpdateEntityNameEvent : public ex::Event<XMLUpdateEntityNameEvent> {
 
         XMLUpdateEntityNameEvent(ex::Entity entity, std::string newName, bool isPrefab) : 
@@ -719,7 +719,7 @@ namespace Raven {
             assets->entitiesByWidget->insert(std::make_pair(sceneHierarchyBox, entity));
             /*
             entity.assign<Tracker>();
-            entity.assign<BoxCollider>()->collisionSettings.insert(COLLISION_LAYER_SETTINGS_SOLID);
+            entity.assign<BoxCollider>()->collisionSettings |= cmn::CollisionInformation::SOLID;
             auto transform = entity.component<Transform>();
             transform->transform.x = (float)position.x - canvas->GetAbsolutePosition().x;
             transform->transform.y = (float)position.y - canvas->GetAbsolutePosition().y;
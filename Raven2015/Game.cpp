@@ -15,17 +15,20 @@
 
 namespace Raven {
 
-    Game::Game(sf::RenderTarget& target) : Game() {
+    Game::Game(sf::RenderTarget& target, cmn::EBroadphase broadphase) : Game(broadphase) {
 
     }
 
-    Game::Game() : EntityX(), editMode(true), defaultLevelPath("Resources/XML/DefaultLevel.xml") {
+    Game::Game(cmn::EBroadphase broadphase) : EntityX(ex::ComponentStorage::SPARSE_SETS), editMode(true), defaultLevelPath("Resources/XML/DefaultLevel.xml"),
+        simulation(entities, events, &simulationWorkers) {
         currentLevelPath = defaultLevelPath;
+        entities.set_thread_pool(&simulationWorkers);
         systems.add<XMLSystem>(&editingEntity);
         assets = &systems.system<XMLSystem>()->assets;
-        systems.add<MovementSystem>();  // No dependencies
+        systems.add<MovementSystem>(&spatialIndex);  // No dependencies
         systems.add<AudioSystem>();     // No dependencies
-        systems.add<CollisionSystem>(); // No dependencies
+        systems.add<CollisionSystem>(broadphase); // No dependencies
+        spatialIndex.configure(events, *systems.system<CollisionSystem>()); // Queries the CollisionSystem's colliders
         systems.add<InputSystem>();     // No dependencies
         systems.add<GUISystem>(systems.system<InputSystem>(), assets, &editingEntity);  // Required that this comes after InputSystem
         systems.add<RenderingSystem>(systems.system<GUISystem>(), assets);              // Required that this comes after GUISystem
@@ -33,6 +36,12 @@ namespace Raven {
         systems.add<ex::deps::Dependency<BoxCollider, Rigidbody, Transform>>();
         systems.configure();
 
+        // In registration order; the scheduler keeps conflicting systems in this order
+        simulation.add(systems.system<InputSystem>());
+        simulation.add(systems.system<MovementSystem>());
+        simulation.add(systems.system<AudioSystem>());
+        simulation.add(systems.system<CollisionSystem>());
+
         cmn::game = this;
     }
 
@@ -44,6 +53,9 @@ namespace Raven {
     void Game::clearWindow() { systems.system<GUISystem>()->clear(); }
     void Game::displayWindow() { systems.system<GUISystem>()->display(); }
     Assets* Game::getAssets() { return assets; }
+    SpatialIndex& Game::getSpatialIndex() { return spatialIndex; }
+
+    ex::CommandBuffer& Game::getCommands() { return commands; }
     
     void Game::initialize() {
         load();
@@ -90,14 +102,31 @@ namespace Raven {
     }
 
     void Game::updateGameMode(ex::TimeDelta dt) {
-        systems.update<InputSystem>(dt);     // process new instructions for entities
-        systems.update<MovementSystem>(dt);  // move entities
-        systems.update<CollisionSystem>(dt); // check whether entities are now colliding
+        // Remember where everything was so rendering can interpolate towards the new positions
+        entities.each<Transform>([](ex::Entity entity, Transform &transform) {
+            transform.previousTransform = transform.transform;
+        });
+        // Process new instructions for entities, move them, then check whether they are now colliding
+        simulation.update(dt);
+        events.dispatch_all();               // deliver the events the systems queued, e.g. collision responses
+        commands.play(entities);             // apply the structural changes the systems deferred
+        spatialIndex.update(entities);       // record where entities without colliders ended up for next tick's queries
+    }
+
+    void Game::renderGameMode(ex::TimeDelta dt, float alpha) {
+        systems.system<RenderingSystem>()->setInterpolation(alpha);
         systems.update<RenderingSystem>(dt); // draw all entities to the Canvas
         systems.update<GUISystem>(dt);       // update and draw GUI widgets
     }
 
+    void Game::setSerialSimulation(bool serial) {
+        simulation.set_serial(serial);
+    }
+
     void Game::updateEditMode(ex::TimeDelta dt) {
+        systems.system<CollisionSystem>()->updateBounds(entities); // pick up colliders placed or moved in the editor
+        spatialIndex.update(entities);       // and every entity without a collider
+        systems.system<RenderingSystem>()->setInterpolation(1.0f);
         systems.update<RenderingSystem>(dt); // draw all entities to the Canvas
         systems.update<GUISystem>(dt);       // update and draw GUI widgets
     }
@@ -3,13 +3,14 @@
 #include "Common.h"
 #include "SFML/Graphics.hpp"
 #include "DataAssetLibrary.h"
+#include "SpatialIndex.h"
 
 namespace Raven {
 
     class Game : public ex::EntityX {
     public:
-        explicit Game(sf::RenderTarget &target);
-        explicit Game();
+        explicit Game(sf::RenderTarget &target, cmn::EBroadphase broadphase = cmn::EBroadphase::SPATIAL_HASH);
+        explicit Game(cmn::EBroadphase broadphase = cmn::EBroadphase::SPATIAL_HASH);
 
         void initialize();
         void loadLevel(std::string levelFilePath, sf::Vector2f levelOffset, bool clearEntitiesBeforehand);
@@ -28,9 +29,20 @@ namespace Raven {
         void clearWindow();
         void displayWindow();
         Assets* getAssets();
+        // The index answering region, ray and nearest-neighbour queries over entities
+        SpatialIndex& getSpatialIndex();
+        // Entity creation, destruction and component changes recorded during the simulation step,
+        // from any thread; they are applied once all simulation systems have finished
+        ex::CommandBuffer& getCommands();
 
+        // Advances the simulation (input, movement, collision) by one fixed step
         void updateGameMode(ex::TimeDelta dt);
+        // Draws the game once per displayed frame, blending alpha (0 to 1) of the way from the
+        // previous simulation step to the current one
+        void renderGameMode(ex::TimeDelta dt, float alpha);
         void updateEditMode(ex::TimeDelta dt);
+        // Runs the simulation systems one after another on the main thread, for debugging
+        void setSerialSimulation(bool serial);
 
         // Provides custom method for assigning default components to an entity
         ex::Entity makeEntity();
@@ -59,6 +71,12 @@ namespace Raven {
         void clearEntities();
         ex::Entity editingEntity;
         Assets* assets;
+        SpatialIndex spatialIndex;
+        ex::CommandBuffer commands;
+        // The threads on which non-conflicting simulation systems run side by side
+        ex::help::ThreadPool simulationWorkers;
+        // Schedules the systems run by updateGameMode according to the components they access
+        ex::SystemScheduler simulation;
     };
 
 }
\ No newline at end of file
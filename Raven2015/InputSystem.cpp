@@ -28,6 +28,10 @@ void InputSystem::update(ex::EntityManager &es, ex::EventManager &events,
     });
 }
 
+void InputSystem::access(ex::ComponentAccess &access) const {
+    access.reads<Pawn>().writes<Rigidbody>();
+}
+
 /// <summary>
 /// Receives KeyboardEvents
 /// </summary>
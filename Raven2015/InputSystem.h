@@ -38,6 +38,9 @@ namespace Raven {
 
         //Update data and perform logic every "tick"
         void update(entityx::EntityManager &es, entityx::EventManager &events, entityx::TimeDelta dt) override;
+
+        // Declares the components touched by update() for the SystemScheduler
+        void access(ex::ComponentAccess &access) const override;
                         
         // Receives KeyboardEvents
         void receive(const KeyboardEvent &event);
@@ -20,6 +20,11 @@ using namespace Raven;
 
 using namespace Raven;
 
+void MovementSystem::access(ex::ComponentAccess &access) const {
+    // The BoxColliders are read by the SpatialIndex's queries
+    access.reads<Tracker, Pawn, BoxCollider>().writes<Transform, Rigidbody, Pacer>();
+}
+
 /*
  * Iterate through each entity containing a Transform and Rigidbody,
  * calculating where it should move to. Uses C++11 Lambda function syntax.
@@ -29,29 +34,17 @@ void MovementSystem::update(ex::EntityManager &es, ex::EventManager &events,
 
     // Acquire each entity containing a tracker
     es.each<Tracker>([&](ex::Entity trackerEntity, Tracker &tracker) {
-        // Distance between two points
-        float xDis = 0.0, yDis = 0.0;
-        // Holds closest pawn's transform
-        float pawnX = 0.0, pawnY = 0.0;
-        // Used for calculating closest pawn to tracker
-        float tempDis = 0.0, minDis =  FLT_MAX;
-        
-        // Find closest pawn to tracker
-        es.each<Pawn>([&](ex::Entity pawnEntity, Pawn &pawn) {
-            xDis = pawnEntity.component<Transform>()->transform.x -
-                trackerEntity.component<Transform>()->transform.x;
-            yDis = pawnEntity.component<Transform>()->transform.y -
-                trackerEntity.component<Transform>()->transform.y;
+        sf::Vector2f trackerPosition = trackerEntity.component<Transform>()->transform;
 
-            tempDis = sqrtf(pow(xDis, 2) + pow(yDis, 2));
+        // Find closest pawn to tracker
+        if (spatialIndex->nearest<Pawn>(trackerPosition, 1, closestPawn, trackerEntity) == 0) {
+            return;
+        }
 
-            
-            if (tempDis < minDis) {
-                minDis = tempDis;
-                pawnX = pawnEntity.component<Transform>()->transform.x;
-                pawnY = pawnEntity.component<Transform>()->transform.y;
-            }
-        });
+        // Distance between the two points
+        sf::Vector2f pawnPosition = closestPawn[0].component<Transform>()->transform;
+        float xDis = pawnPosition.x - trackerPosition.x;
+        float yDis = pawnPosition.y - trackerPosition.y;
 
         // Transform tracker towards pawn
         // If xDis is negative, pawn is to left of tracker
@@ -97,9 +90,10 @@ void MovementSystem::update(ex::EntityManager &es, ex::EventManager &events,
         entity.component<Rigidbody>()->velocity = pacer.velocity;
     });
 
-    // Acquire each entity containing a transform and a rigidbody
-    es.each<Transform, Rigidbody>(
-        [dt](ex::Entity entity, Transform &transform,Rigidbody &rigidbody) {
+    // Acquire each entity containing a transform and a rigidbody, spread over the worker threads.
+    // Only the two components passed in may be touched here.
+    es.parallel_each<Transform, Rigidbody>(
+        [dt](ex::Entity entity, Transform &transform, Rigidbody &rigidbody) {
 
         // Update its transform based on its rigidbody data.
         transform.transform.x += rigidbody.velocity.x;
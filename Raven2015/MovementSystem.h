@@ -13,6 +13,7 @@
 
 #include "entityx\System.h"
 #include "../Common.h"
+#include "SpatialIndex.h"
 
 namespace Raven {
 
@@ -21,9 +22,9 @@ namespace Raven {
     public:
 
         /*
-         * Default null constructor
+         * Initializes the system with the index used to find the pawns that Trackers follow
          */
-        explicit MovementSystem() {
+        explicit MovementSystem(SpatialIndex *spatialIndex) : spatialIndex(spatialIndex) {
 
         }
 
@@ -33,6 +34,16 @@ namespace Raven {
         void update(ex::EntityManager &es, ex::EventManager &events,
             ex::TimeDelta dt) override;
 
+        /*
+         * Declares the components touched by update() for the SystemScheduler
+         */
+        void access(ex::ComponentAccess &access) const override;
+
+    private:
+        SpatialIndex *spatialIndex;
+
+        // Reused between ticks for the result of the closest-pawn query
+        std::vector<ex::Entity> closestPawn;
     };
 
 }
@@ -0,0 +1,133 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include "Narrowphase.h"
+#include <algorithm>            // For std::fill
+#include <cmath>                // For std::abs
+
+#if defined(RAVEN_NARROWPHASE_AVX)
+#include <immintrin.h>          // For the AVX intrinsics
+#elif defined(RAVEN_NARROWPHASE_SSE2)
+#include <emmintrin.h>          // For the SSE2 intrinsics
+#endif
+
+using namespace Raven;
+
+#if defined(RAVEN_NARROWPHASE_AVX)
+const std::size_t NarrowphaseBatch::LANES = 8;
+#elif defined(RAVEN_NARROWPHASE_SSE2)
+const std::size_t NarrowphaseBatch::LANES = 4;
+#else
+const std::size_t NarrowphaseBatch::LANES = 1;
+#endif
+
+namespace {
+    // The number of set bits in a movemask result (at most 8 bits wide)
+    inline std::size_t countBits(unsigned int mask) {
+        std::size_t count = 0;
+        for (; mask; mask &= mask - 1) {
+            ++count;
+        }
+        return count;
+    }
+}
+
+void NarrowphaseBatch::clear() {
+    leftX.clear(); leftY.clear(); leftHalfWidth.clear(); leftHalfHeight.clear();
+    rightX.clear(); rightY.clear(); rightHalfWidth.clear(); rightHalfHeight.clear();
+}
+
+void NarrowphaseBatch::reserve(std::size_t pairCount) {
+    leftX.reserve(pairCount); leftY.reserve(pairCount);
+    leftHalfWidth.reserve(pairCount); leftHalfHeight.reserve(pairCount);
+    rightX.reserve(pairCount); rightY.reserve(pairCount);
+    rightHalfWidth.reserve(pairCount); rightHalfHeight.reserve(pairCount);
+}
+
+void NarrowphaseBatch::add(const ColliderBounds &left, const ColliderBounds &right) {
+    leftX.push_back((left.left + left.right) * 0.5f);
+    leftY.push_back((left.top + left.bottom) * 0.5f);
+    leftHalfWidth.push_back((left.right - left.left) * 0.5f);
+    leftHalfHeight.push_back((left.bottom - left.top) * 0.5f);
+    rightX.push_back((right.left + right.right) * 0.5f);
+    rightY.push_back((right.top + right.bottom) * 0.5f);
+    rightHalfWidth.push_back((right.right - right.left) * 0.5f);
+    rightHalfHeight.push_back((right.bottom - right.top) * 0.5f);
+}
+
+std::size_t NarrowphaseBatch::test(std::vector<std::uint32_t> &hits) const {
+    const std::size_t n = size();
+    hits.resize((n + 31) / 32);
+    std::fill(hits.begin(), hits.end(), 0u);
+
+    std::size_t count = 0;
+    std::size_t i = 0;
+
+#if defined(RAVEN_NARROWPHASE_AVX)
+    // Clearing the sign bit yields the absolute value
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    for (; i + 8 <= n; i += 8) {
+        __m256 dx = _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_load_ps(&leftX[i]), _mm256_load_ps(&rightX[i])));
+        __m256 dy = _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_load_ps(&leftY[i]), _mm256_load_ps(&rightY[i])));
+        __m256 reachX = _mm256_add_ps(_mm256_load_ps(&leftHalfWidth[i]), _mm256_load_ps(&rightHalfWidth[i]));
+        __m256 reachY = _mm256_add_ps(_mm256_load_ps(&leftHalfHeight[i]), _mm256_load_ps(&rightHalfHeight[i]));
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(dx, reachX, _CMP_LE_OQ), _mm256_cmp_ps(dy, reachY, _CMP_LE_OQ));
+
+        unsigned int mask = (unsigned int)_mm256_movemask_ps(hit);
+        hits[i >> 5] |= std::uint32_t(mask) << (i & 31);
+        count += countBits(mask);
+    }
+#elif defined(RAVEN_NARROWPHASE_SSE2)
+    // Clearing the sign bit yields the absolute value
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 dx = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_load_ps(&leftX[i]), _mm_load_ps(&rightX[i])));
+        __m128 dy = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_load_ps(&leftY[i]), _mm_load_ps(&rightY[i])));
+        __m128 reachX = _mm_add_ps(_mm_load_ps(&leftHalfWidth[i]), _mm_load_ps(&rightHalfWidth[i]));
+        __m128 reachY = _mm_add_ps(_mm_load_ps(&leftHalfHeight[i]), _mm_load_ps(&rightHalfHeight[i]));
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(dx, reachX), _mm_cmple_ps(dy, reachY));
+
+        unsigned int mask = (unsigned int)_mm_movemask_ps(hit);
+        hits[i >> 5] |= std::uint32_t(mask) << (i & 31);
+        count += countBits(mask);
+    }
+#endif
+
+    // Whatever does not fill a whole register is finished off one pair at a time
+    return count + testRange(i, hits);
+}
+
+std::size_t NarrowphaseBatch::testScalar(std::vector<std::uint32_t> &hits) const {
+    hits.resize((size() + 31) / 32);
+    std::fill(hits.begin(), hits.end(), 0u);
+    return testRange(0, hits);
+}
+
+std::size_t NarrowphaseBatch::testRange(std::size_t first, std::vector<std::uint32_t> &hits) const {
+    std::size_t count = 0;
+    for (std::size_t i = first; i < size(); ++i) {
+        if (std::abs(leftX[i] - rightX[i]) <= leftHalfWidth[i] + rightHalfWidth[i] &&
+            std::abs(leftY[i] - rightY[i]) <= leftHalfHeight[i] + rightHalfHeight[i]) {
+            hits[i >> 5] |= std::uint32_t(1) << (i & 31);
+            ++count;
+        }
+    }
+    return count;
+}
+
+sf::Vector2f NarrowphaseBatch::getPoint(std::size_t i) const {
+    return sf::Vector2f((leftX[i] + rightX[i]) * 0.5f, (leftY[i] + rightY[i]) * 0.5f);
+}
+
+sf::Vector2f NarrowphaseBatch::getPenetration(std::size_t i) const {
+    return sf::Vector2f(leftHalfWidth[i] + rightHalfWidth[i] - std::abs(leftX[i] - rightX[i]),
+        leftHalfHeight[i] + rightHalfHeight[i] - std::abs(leftY[i] - rightY[i]));
+}
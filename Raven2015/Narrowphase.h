@@ -0,0 +1,120 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include <cstddef>              // For std::size_t
+#include <cstdint>              // For std::uint32_t, std::uintptr_t
+#include <new>                  // For ::operator new, ::operator delete
+#include <vector>               // For std::vector
+#include "SFML/System.hpp"      // For sf::Vector2f
+#include "Broadphase.h"         // For ColliderBounds
+
+// Pick the widest instruction set the compiler was told it may use
+#if defined(__AVX__)
+#define RAVEN_NARROWPHASE_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAVEN_NARROWPHASE_SSE2
+#endif
+
+namespace Raven {
+
+    /*
+     * A minimal allocator handing out storage aligned for SIMD loads.
+     * The original pointer is stashed just in front of the aligned block.
+     */
+    template <typename T, std::size_t Alignment = 32>
+    struct AlignedAllocator {
+        typedef T value_type;
+
+        template <typename U>
+        struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+        AlignedAllocator() {}
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+        T *allocate(std::size_t n) {
+            void *raw = ::operator new(n * sizeof(T) + Alignment + sizeof(void*));
+            std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + Alignment - 1) &
+                ~std::uintptr_t(Alignment - 1);
+            reinterpret_cast<void**>(aligned)[-1] = raw;
+            return reinterpret_cast<T*>(aligned);
+        }
+
+        void deallocate(T *p, std::size_t) {
+            ::operator delete(reinterpret_cast<void**>(p)[-1]);
+        }
+
+        template <typename U>
+        bool operator == (const AlignedAllocator<U, Alignment> &) const { return true; }
+
+        template <typename U>
+        bool operator != (const AlignedAllocator<U, Alignment> &) const { return false; }
+    };
+
+    /*
+     * A structure-of-arrays batch of collider pairs for the narrowphase. The centres and
+     * half-extents of both colliders of each pair are packed into aligned float arrays so
+     * that the overlap test runs on 8 (AVX) or 4 (SSE2) pairs per instruction.
+     */
+    class NarrowphaseBatch {
+    public:
+        typedef std::vector<float, AlignedAllocator<float>> FloatArray;
+
+        // The number of pairs tested per instruction by test()
+        static const std::size_t LANES;
+
+        // Removes every pair while keeping the storage
+        void clear();
+
+        // Preallocates storage for the given number of pairs
+        void reserve(std::size_t pairCount);
+
+        // Appends a pair of colliders to the batch
+        void add(const ColliderBounds &left, const ColliderBounds &right);
+
+        // The number of pairs in the batch
+        std::size_t size() const { return leftX.size(); }
+
+        /*
+         * Tests every pair for overlap (edges count, as in CollisionSystem::testCollision).
+         * Bit (i % 32) of hits[i / 32] is set when pair i overlaps. Returns the number of hits.
+         */
+        std::size_t test(std::vector<std::uint32_t> &hits) const;
+
+        // Same as test(), but always one pair at a time. Used as a reference and a fallback.
+        std::size_t testScalar(std::vector<std::uint32_t> &hits) const;
+
+        // Whether pair i was marked as overlapping in the given hit mask
+        static bool isHit(const std::vector<std::uint32_t> &hits, std::size_t i) {
+            return (hits[i >> 5] >> (i & 31)) & 1u;
+        }
+
+        // The approximate point of impact of pair i, midway between the two centres
+        sf::Vector2f getPoint(std::size_t i) const;
+
+        // How far the colliders of pair i overlap on each axis
+        sf::Vector2f getPenetration(std::size_t i) const;
+
+    private:
+        // Scalar test of the pairs in [first, size()), used for the tail of a SIMD pass
+        std::size_t testRange(std::size_t first, std::vector<std::uint32_t> &hits) const;
+
+        // The centres of the colliders on each side of every pair
+        FloatArray leftX, leftY, rightX, rightY;
+
+        // The half-extents of the colliders on each side of every pair
+        FloatArray leftHalfWidth, leftHalfHeight, rightHalfWidth, rightHalfHeight;
+    };
+
+}
@@ -0,0 +1,62 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include "RenderList.h"
+#include <algorithm>            // For std::sort, std::equal, std::min, std::max
+
+using namespace Raven;
+
+namespace {
+    const std::int64_t PRIORITY_OFFSET = std::int64_t(1) << 23;
+    const std::int64_t PRIORITY_MAX = (std::int64_t(1) << 24) - 1;
+
+    bool sameRecord(const RenderRecord &a, const RenderRecord &b) {
+        return a.key == b.key && a.entity == b.entity && a.renderable == b.renderable;
+    }
+}
+
+std::uint64_t RenderList::makeKey(cmn::ERenderingLayer layer, int priority, std::uint32_t textureId) {
+    std::int64_t offsetPriority = std::min(std::max(std::int64_t(priority) + PRIORITY_OFFSET, std::int64_t(0)), PRIORITY_MAX);
+    return (std::uint64_t(layer & 0xFF) << 56) | (std::uint64_t(offsetPriority) << 32) | textureId;
+}
+
+void RenderList::begin() {
+    collected.clear();
+}
+
+void RenderList::add(ex::Entity::Id entity, const Renderable &renderable, std::uint32_t textureId) {
+    RenderRecord record;
+    record.key = makeKey(renderable.renderLayer, renderable.renderPriority, textureId);
+    record.entity = entity.id();
+    record.order = std::uint32_t(collected.size());
+    record.renderable = &renderable;
+    collected.push_back(record);
+}
+
+void RenderList::end() {
+    if (collected.size() == previous.size() &&
+            std::equal(collected.begin(), collected.end(), previous.begin(), sameRecord)) {
+        return;
+    }
+
+    sorted = collected;
+    std::sort(sorted.begin(), sorted.end(), [](const RenderRecord &a, const RenderRecord &b) {
+        if (a.key != b.key) {
+            return a.key < b.key;
+        }
+        if (a.entity != b.entity) {
+            return a.entity < b.entity;
+        }
+        return a.order < b.order;
+    });
+    previous.swap(collected);
+    ++sortCount;
+}
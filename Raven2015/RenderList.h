@@ -0,0 +1,81 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include <cstddef>              // For std::size_t
+#include <cstdint>              // For std::uint32_t, std::uint64_t
+#include <vector>               // For std::vector
+#include "entityx\Entity.h"     // For ex::Entity::Id
+#include "Common.h"             // For cmn::ERenderingLayer
+#include "DataAssetLibrary.h"   // For Renderable
+
+namespace Raven {
+
+    // A Renderable's place in the draw order
+    struct RenderRecord {
+
+        // The layer, priority and texture of the Renderable, see RenderList::makeKey
+        std::uint64_t key;
+
+        // The entity owning the Renderable, which breaks ties between equal keys
+        std::uint64_t entity;
+
+        // The position at which the Renderable was added, which breaks ties within an entity
+        std::uint32_t order;
+
+        const Renderable *renderable;
+    };
+
+    /*
+     * The Renderables of a frame in draw order: by layer, then priority, then texture (so that
+     * sprites at the same depth form runs that SpriteBatch can merge), then by owning entity.
+     *
+     * The list is rebuilt every frame from the Renderers, but only sorted again when a record
+     * differs from the previous frame's, as the layers, priorities and textures of most scenes
+     * rarely change.
+     */
+    class RenderList {
+    public:
+        /*
+         * Packs a draw order into one integer: the layer in the top 8 bits, the priority in the
+         * next 24 (clamped, and offset so that negative priorities sort first) and a texture id
+         * in the low 32. Drawables without a texture use id 0.
+         */
+        static std::uint64_t makeKey(cmn::ERenderingLayer layer, int priority, std::uint32_t textureId);
+
+        // Starts collecting the Renderables of a new frame
+        void begin();
+
+        // Adds a Renderable of the given entity. It must stay alive until the frame is drawn.
+        void add(ex::Entity::Id entity, const Renderable &renderable, std::uint32_t textureId);
+
+        // Puts the collected Renderables in draw order, sorting only if they changed
+        void end();
+
+        // The Renderables collected up to the last end(), in draw order
+        const std::vector<RenderRecord> &getRecords() const { return sorted; }
+
+        // The number of times end() had to sort
+        std::size_t getSortCount() const { return sortCount; }
+
+    private:
+        // The records of the current frame, and of the previous one, in the order they were added
+        std::vector<RenderRecord> collected;
+        std::vector<RenderRecord> previous;
+
+        // The records of the previous frame in draw order
+        std::vector<RenderRecord> sorted;
+
+        std::size_t sortCount = 0;
+    };
+
+}
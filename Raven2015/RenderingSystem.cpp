@@ -11,20 +11,45 @@ using namespace Raven;
 
     void RenderingSystem::receive(const GUIRegisterTextureEvent& e) {
         if (e.textureFilePath != "") {
-            textureMap.insert(std::make_pair(e.textureFilePath, sf::Texture()));
+            textureFilePaths.insert(e.textureFilePath);
+            atlasOutdated = true;
         }
         else {
             cerr << "Warning: Failed attempt to load texture with empty string name" << endl;
         }
-        if (!textureMap[e.textureFilePath].loadFromFile(e.textureFilePath.c_str())) {
-            cerr << "Warning: Failed to load texture at path: " + e.textureFilePath << endl;
-        }
     }
 
+void RenderingSystem::updateTextureAtlas() {
+    if (!textureAtlas.load(textureFilePaths)) {
+        cerr << "Warning: Some textures are missing from the texture atlas" << endl;
+    }
+
+    // The old pages are gone, and a new page may reuse an old one's address
+    textureIds.clear();
+
+    for (auto &name_animation : *assets->animations) {
+        name_animation.second->placeInAtlas(textureAtlas.getRect(name_animation.second->textureFileName));
+    }
+    atlasOutdated = false;
+}
+
+std::uint32_t RenderingSystem::getTextureId(const sf::Texture *texture) {
+    if (!texture) {
+        return 0;
+    }
+    auto found = textureIds.find(texture);
+    if (found != textureIds.end()) {
+        return found->second;
+    }
+    std::uint32_t id = std::uint32_t(textureIds.size()) + 1;
+    textureIds.insert(std::make_pair(texture, id));
+    return id;
+}
+
 // Updates all rendered assets by following the sequence below. 
 // 1. Increments any and all animations by 1 frame. 
-// 2. Sorts all current renderable assets based on their draw layer and priority. 
-// 3. Iterates through each asset from back to front, drawing them. 
+// 2. Collects all current renderable assets into the render list, which sorts them by layer, priority and texture when they change. 
+// 3. Iterates through each asset from back to front, drawing runs of sprites that share a texture at once. 
 void RenderingSystem::update(entityx::EntityManager &es, entityx::EventManager &events, entityx::TimeDelta dt) {
 
     // Error checking for window validity
@@ -33,6 +58,11 @@ void RenderingSystem::update(entityx::EntityManager &es, entityx::EventManager &
         throw 1;
     }
 
+    // Pack any newly registered textures before their sprites are drawn
+    if (atlasOutdated) {
+        updateTextureAtlas();
+    }
+
     // Determine the next image to be drawn to the screen for each sprite
     es.each<Renderer>([&](ex::Entity &entity, Renderer &renderer) {
 
@@ -85,81 +115,91 @@ void RenderingSystem::update(entityx::EntityManager &es, entityx::EventManager &
         }
     });
     
-    // Generate the sorted heap
+    // Collect the draw order
+    renderList.begin();
     es.each<Renderer>([this](ex::Entity &entity, Renderer &renderer) {
 
-        for (std::pair<std::string, std::shared_ptr<RenderableSprite>> name_renderable : renderer.sprites) {
-            renderableHeap.push(*name_renderable.second);
-
+        for (auto &name_renderable : renderer.sprites) {
             // Acquire the transform of the entity
             ex::ComponentHandle<Transform> transform = entity.component<Transform>();
 
             // Ensure that the asset is positioned properly
             if (transform) {
+                sf::Vector2f position = getRenderPosition(*transform.get());
                 name_renderable.second->sprite.setPosition(
-                    transform->transform.x - name_renderable.second->sprite.getTextureRect().width*0.75f + name_renderable.second->offsetX,
-                    transform->transform.y - name_renderable.second->sprite.getTextureRect().width*1.5f + name_renderable.second->offsetY);
+                    position.x - name_renderable.second->sprite.getTextureRect().width*0.75f + name_renderable.second->offsetX,
+                    position.y - name_renderable.second->sprite.getTextureRect().width*1.5f + name_renderable.second->offsetY);
             }
 
-            // If the exact address of this texture is not the same as the one on record, reacquire it
-            if (name_renderable.second->sprite.getTexture() != &textureMap[name_renderable.second->textureFileName]) {
-                //cout << "Note: Re-applying texture to sprite" << endl;
-                //This section is always entered for some reason...
-                name_renderable.second->sprite.setTexture(textureMap[name_renderable.second->textureFileName]);
+            // If the exact address of this texture's atlas page is not the same as the one on record, reacquire it
+            const sf::Texture *texture = textureAtlas.getTexture(name_renderable.second->textureFileName);
+            if (texture && name_renderable.second->sprite.getTexture() != texture) {
+                name_renderable.second->sprite.setTexture(*texture);
             }
+
+            // Sprites without an animation show the whole of their texture's region of the page
+            if (assets->animations->count(name_renderable.second->animName) == 0) {
+                name_renderable.second->sprite.setTextureRect(textureAtlas.getRect(name_renderable.second->textureFileName));
+            }
+
+            renderList.add(entity.id(), *name_renderable.second, getTextureId(name_renderable.second->sprite.getTexture()));
         }
 
-        for (std::pair<std::string, std::shared_ptr<RenderableRectangle>> name_renderable : renderer.rectangles) {
-            renderableHeap.push(*name_renderable.second);
+        for (auto &name_renderable : renderer.rectangles) {
+            renderList.add(entity.id(), *name_renderable.second, 0);
 
             // Acquire the transform of the entity
             ex::ComponentHandle<Transform> transform = entity.component<Transform>();
 
             // Ensure that the asset is positioned properly
             if (transform) {
+                sf::Vector2f position = getRenderPosition(*transform.get());
                 name_renderable.second->rectangle.setPosition(
-                    transform->transform.x - cmn::STD_UNITX*.5f + name_renderable.second->offsetX,
-                    transform->transform.y - cmn::STD_UNITY*.5f + name_renderable.second->offsetY);
+                    position.x - cmn::STD_UNITX*.5f + name_renderable.second->offsetX,
+                    position.y - cmn::STD_UNITY*.5f + name_renderable.second->offsetY);
             }
         }
 
-        for (std::pair<std::string, std::shared_ptr<RenderableCircle>> name_renderable : renderer.circles) {
-            renderableHeap.push(*name_renderable.second);
+        for (auto &name_renderable : renderer.circles) {
+            renderList.add(entity.id(), *name_renderable.second, 0);
 
             // Acquire the transform of the entity
             ex::ComponentHandle<Transform> transform = entity.component<Transform>();
 
             // Ensure that the asset is positioned properly
             if (transform) {
+                sf::Vector2f position = getRenderPosition(*transform.get());
                 name_renderable.second->circle.setPosition(
-                    transform->transform.x - cmn::STD_UNITX*.5f + name_renderable.second->offsetX,
-                    transform->transform.y - cmn::STD_UNITY*.5f + name_renderable.second->offsetY);
+                    position.x - cmn::STD_UNITX*.5f + name_renderable.second->offsetX,
+                    position.y - cmn::STD_UNITY*.5f + name_renderable.second->offsetY);
             }
         }
 
-        for (std::pair<std::string, std::shared_ptr<RenderableText>> name_renderable : renderer.texts) {
-            renderableHeap.push(*name_renderable.second);
+        for (auto &name_renderable : renderer.texts) {
+            renderList.add(entity.id(), *name_renderable.second, 0);
 
             // Acquire the transform of the entity
             ex::ComponentHandle<Transform> transform = entity.component<Transform>();
 
             // Ensure that the asset is positioned properly
             if (transform) {
+                sf::Vector2f position = getRenderPosition(*transform.get());
                 name_renderable.second->text.setPosition(
-                    transform->transform.x - cmn::STD_UNITX*.5f + name_renderable.second->offsetX,
-                    transform->transform.y - cmn::STD_UNITY*.5f + name_renderable.second->offsetY);
+                    position.x - cmn::STD_UNITX*.5f + name_renderable.second->offsetX,
+                    position.y - cmn::STD_UNITY*.5f + name_renderable.second->offsetY);
             }
         }
     });
+    renderList.end();
 
-    // Pop every sprite off the heap, drawing them as you go
-    std::shared_ptr<Renderable> renderable = nullptr;
+    // Draw everything in order, batching sprites that share a texture
+    spriteBatch.clear();
+    for (const RenderRecord &record : renderList.getRecords()) {
+        spriteBatch.add(*record.renderable);
+    }
     canvas->Bind();
     canvas->Clear(sf::Color::Black);
-    while (!renderableHeap.empty()) {
-        canvas->Draw(*renderableHeap.top().drawPtr);
-        renderableHeap.pop();
-    }
+    spriteBatch.draw(*canvas);
     canvas->Display();
     canvas->Unbind();
 }
@@ -3,10 +3,14 @@
 #include "../Common.h"
 #include "entityx\System.h"
 #include "../EventLibrary.h"
-#include <map>
-#include <queue>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
 #include "GUISystem.h"
 #include "DataAssetLibrary.h"
+#include "SpriteBatch.h"
+#include "RenderList.h"
+#include "TextureAtlas.h"
 
 namespace Raven {
 
@@ -15,18 +19,27 @@ namespace Raven {
     public:
         // Perform initializations
         explicit RenderingSystem(std::shared_ptr<GUISystem> system, Assets* assets)
-            : renderWindow(system->mainWindow), canvas(system->canvas), assets(assets) {}
+            : renderWindow(system->mainWindow), canvas(system->canvas), assets(assets), interpolation(1.0f),
+            atlasOutdated(false) {}
 
         // Subscribe to events
         void configure(entityx::EventManager &event_manager) {
             event_manager.subscribe<GUIRegisterTextureEvent>(*this);
         }
 
-        // Registers texture assets for usage
+        // Registers texture assets for usage, to be packed into the texture atlas before the next frame
         void receive(const GUIRegisterTextureEvent& e);
 
         // Add or remove textures & sprites dynamically, drawing sprites that are within view
         void update(entityx::EntityManager &es, entityx::EventManager &events, entityx::TimeDelta dt) override;
+
+        // Sets how far (0 to 1) the next frame lies between the last two simulation steps
+        void setInterpolation(float alpha) { interpolation = alpha; }
+
+        // The position at which the entity is drawn, between its previous and current Transform
+        sf::Vector2f getRenderPosition(const Transform &transform) const {
+            return transform.previousTransform + (transform.transform - transform.previousTransform) * interpolation;
+        }
             
         // A pointer to the window that displays the widgets
         std::shared_ptr<sf::RenderWindow> renderWindow;
@@ -34,14 +47,35 @@ namespace Raven {
         // A pointer to the widget used for rendering
         std::shared_ptr<Canvas> canvas;
 
-        // A Renderable min-heap for determining draw order of text, shapes, and sprites
-        std::priority_queue<Renderable> renderableHeap;
+        // The text, shapes, and sprites of every Renderer in draw order, kept between frames
+        RenderList renderList;
+
+        // Merges the frame's sprites into one draw call per run of sprites sharing a texture
+        SpriteBatch spriteBatch;
+
+        // Every registered texture (derived from Assets), packed into a few shared pages
+        TextureAtlas textureAtlas;
 
-        // A mapping of texture file paths (derived from Assets) to sf::Texture objects
-        std::map<std::string, sf::Texture> textureMap;
+        // The file paths of the registered textures
+        std::set<std::string> textureFilePaths;
+
+        // Repacks the texture atlas and moves every Animation's frames onto it
+        void updateTextureAtlas();
+
+        // The id standing for each texture in the render list's sort keys
+        std::uint32_t getTextureId(const sf::Texture *texture);
+
+        // The ids handed out by getTextureId, from 1 in order of first use
+        std::unordered_map<const sf::Texture*, std::uint32_t> textureIds;
 
         // A pointer to the assets contained within the XMLSystem
         Assets* assets;
+
+        // The blend factor between the previous and current Transform used when drawing
+        float interpolation;
+
+        // Whether textures were registered since the texture atlas was last packed
+        bool atlasOutdated;
     };
 
 }
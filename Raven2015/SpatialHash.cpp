@@ -0,0 +1,137 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include "SpatialHash.h"
+#include <algorithm>            // For std::max
+#include <cmath>                // For std::floor
+
+using namespace Raven;
+
+SpatialHash::SpatialHash(float cellWidth, float cellHeight) {
+    setCellSize(cellWidth, cellHeight);
+}
+
+void SpatialHash::setCellSize(float cellWidth, float cellHeight) {
+    // Guard against degenerate cells, which would put every collider in its own column
+    this->cellWidth = cellWidth > 0.0f ? cellWidth : cmn::STD_UNITX;
+    this->cellHeight = cellHeight > 0.0f ? cellHeight : cmn::STD_UNITY;
+}
+
+int SpatialHash::columnOf(float x) const {
+    return (int)std::floor(x / cellWidth);
+}
+
+int SpatialHash::rowOf(float y) const {
+    return (int)std::floor(y / cellHeight);
+}
+
+/*
+ * Cells that were left empty for an entire tick are dropped so that the table only
+ * holds the region of the world that is actually populated.
+ */
+void SpatialHash::clear() {
+    bounds.clear();
+    for (auto it = cells.begin(); it != cells.end();) {
+        if (it->second.empty()) {
+            it = cells.erase(it);
+        }
+        else {
+            it->second.clear();
+            ++it;
+        }
+    }
+}
+
+void SpatialHash::update(const std::vector<ColliderBounds> &colliderBounds) {
+    clear();
+    for (const ColliderBounds &b : colliderBounds) {
+        insert(b);
+    }
+}
+
+void SpatialHash::insert(const ColliderBounds &colliderBounds) {
+    std::size_t index = bounds.size();
+    bounds.push_back(colliderBounds);
+
+    int minColumn = columnOf(colliderBounds.left), maxColumn = columnOf(colliderBounds.right);
+    int minRow = rowOf(colliderBounds.top), maxRow = rowOf(colliderBounds.bottom);
+    for (int column = minColumn; column <= maxColumn; ++column) {
+        for (int row = minRow; row <= maxRow; ++row) {
+            cells[makeKey(column, row)].push_back(index);
+        }
+    }
+}
+
+/*
+ * Colliders spanning several cells may meet in more than one of them. A pair is only
+ * reported by the cell holding the top-left corner of their overlap, which both
+ * colliders are guaranteed to occupy, so no further de-duplication is required.
+ * Partitions take every partitionCount-th bucket of the table, so each cell, and
+ * therefore each pair, belongs to exactly one partition.
+ */
+void SpatialHash::findPairs(std::vector<EntityPair> &pairs, std::size_t partition,
+    std::size_t partitionCount) const {
+
+    for (std::size_t bucket = partition; bucket < cells.bucket_count(); bucket += partitionCount) {
+        for (auto key_cell = cells.begin(bucket); key_cell != cells.end(bucket); ++key_cell) {
+            const std::vector<std::size_t> &cell = key_cell->second;
+            for (std::size_t i = 0; i < cell.size(); ++i) {
+                const ColliderBounds &left = bounds[cell[i]];
+                for (std::size_t j = i + 1; j < cell.size(); ++j) {
+                    const ColliderBounds &right = bounds[cell[j]];
+                    if (!left.canCollide(right) || !left.overlaps(right)) {
+                        continue;
+                    }
+                    int column = columnOf(std::max(left.left, right.left));
+                    int row = rowOf(std::max(left.top, right.top));
+                    if (makeKey(column, row) == key_cell->first) {
+                        pairs.push_back(std::make_pair(left.entity, right.entity));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*
+ * As with pairs, a collider spanning several of the cells is only reported by the cell holding
+ * the top-left corner of its overlap with the area. An area covering more cells than there are
+ * colliders is cheaper to answer by checking every collider.
+ */
+void SpatialHash::queryBounds(float left, float top, float right, float bottom, QueryVisitor &visitor) const {
+    float cellCount = ((right - left) / cellWidth + 2.0f) * ((bottom - top) / cellHeight + 2.0f);
+    if (!(cellCount <= float(bounds.size()))) {
+        for (const ColliderBounds &b : bounds) {
+            if (b.left <= right && left <= b.right && b.top <= bottom && top <= b.bottom) {
+                visitor.visit(b);
+            }
+        }
+        return;
+    }
+
+    int minColumn = columnOf(left), maxColumn = columnOf(right);
+    int minRow = rowOf(top), maxRow = rowOf(bottom);
+    for (int column = minColumn; column <= maxColumn; ++column) {
+        for (int row = minRow; row <= maxRow; ++row) {
+            auto found = cells.find(makeKey(column, row));
+            if (found == cells.end()) {
+                continue;
+            }
+            for (std::size_t index : found->second) {
+                const ColliderBounds &b = bounds[index];
+                if (b.left <= right && left <= b.right && b.top <= bottom && top <= b.bottom &&
+                    columnOf(std::max(b.left, left)) == column && rowOf(std::max(b.top, top)) == row) {
+                    visitor.visit(b);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include <cstdint>              // For std::int64_t
+#include <unordered_map>        // For std::unordered_map
+#include "Broadphase.h"         // For Broadphase, ColliderBounds
+
+namespace Raven {
+
+    /*
+     * A uniform-grid broadphase. Colliders are registered in every cell that their bounds
+     * overlap, and only colliders that share a cell are ever reported as candidate pairs.
+     */
+    class SpatialHash : public Broadphase {
+    public:
+        // Initializes a grid whose cells have the given dimensions, in pixels
+        explicit SpatialHash(float cellWidth = cmn::STD_UNITX, float cellHeight = cmn::STD_UNITY);
+
+        // Empties every cell while keeping the storage of recently used cells for the next tick
+        void clear();
+
+        // Registers the bounds in every cell that they overlap
+        void insert(const ColliderBounds &bounds);
+
+        // Re-registers every collider from scratch
+        void update(const std::vector<ColliderBounds> &bounds) override;
+
+        using Broadphase::findPairs;
+
+        // Appends each overlapping pair found in the hash buckets assigned to the partition
+        void findPairs(std::vector<EntityPair> &pairs, std::size_t partition,
+            std::size_t partitionCount) const override;
+
+        // Changes the cell dimensions. Takes effect from the next insert onwards.
+        void setCellSize(float cellWidth, float cellHeight);
+
+        float getCellWidth() const { return cellWidth; }
+        float getCellHeight() const { return cellHeight; }
+
+        std::size_t size() const override { return bounds.size(); }
+
+    protected:
+        // Looks in the cells covering the area
+        void queryBounds(float left, float top, float right, float bottom, QueryVisitor &visitor) const override;
+
+    private:
+        typedef std::int64_t CellKey;
+
+        // Packs the column/row of a cell into a single hashable key
+        static CellKey makeKey(int column, int row) {
+            return (CellKey(column) << 32) | CellKey(std::uint32_t(row));
+        }
+
+        // The column containing the given x-coordinate
+        int columnOf(float x) const;
+
+        // The row containing the given y-coordinate
+        int rowOf(float y) const;
+
+        // The dimensions of each cell
+        float cellWidth, cellHeight;
+
+        // Every collider registered since the last clear()
+        std::vector<ColliderBounds> bounds;
+
+        // Maps each occupied cell to the indices (into bounds) of the colliders overlapping it
+        std::unordered_map<CellKey, std::vector<std::size_t>> cells;
+    };
+
+}
@@ -0,0 +1,197 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include "SpatialIndex.h"
+#include <algorithm>            // For std::sort, std::binary_search, std::min, std::max
+#include <cmath>                // For std::sqrt
+
+using namespace Raven;
+
+void SpatialIndex::configure(ex::EventManager &events, const CollisionSystem &collision) {
+    this->collision = &collision;
+    events.subscribe<ex::EntityDestroyedEvent>(*this);
+    events.subscribe<ex::ComponentRemovedEvent<Transform>>(*this);
+}
+
+void SpatialIndex::update(ex::EntityManager &es) {
+    std::size_t count = 0;
+    es.each<Transform>([&](ex::Entity entity, Transform &transform) {
+        if (entity.has_component<BoxCollider>()) {
+            return;
+        }
+        ++count;
+        points.move(ColliderBounds(entity, transform.transform.x, transform.transform.y,
+            transform.transform.x, transform.transform.y, 0, 0));
+    });
+
+    // Entities normally leave through the events; this catches any that slipped past them
+    // or that gained a BoxCollider
+    if (points.size() != count) {
+        currentIds.clear();
+        es.each<Transform>([&](ex::Entity entity, Transform &transform) {
+            if (!entity.has_component<BoxCollider>()) {
+                currentIds.push_back(entity.id().id());
+            }
+        });
+        std::sort(currentIds.begin(), currentIds.end());
+
+        std::vector<ex::Entity::Id> stale;
+        points.forEach([&](const ColliderBounds &b) {
+            if (!std::binary_search(currentIds.begin(), currentIds.end(), b.entity.id().id())) {
+                stale.push_back(b.entity.id());
+            }
+        });
+        for (ex::Entity::Id id : stale) {
+            points.remove(id);
+        }
+    }
+}
+
+std::size_t SpatialIndex::queryAABB(const sf::FloatRect &area, std::vector<ex::Entity> &results) const {
+    results.clear();
+    float right = area.left + area.width, bottom = area.top + area.height;
+    auto collect = [&](const ColliderBounds &b) {
+        // The trees' boxes are fattened, so the entity's own bounds decide
+        if (b.left <= right && area.left <= b.right && b.top <= bottom && area.top <= b.bottom) {
+            results.push_back(b.entity);
+        }
+    };
+    points.query(area.left, area.top, right, bottom, collect);
+    if (collision) {
+        collision->getStaticTree().query(area.left, area.top, right, bottom, collect);
+        collision->broadphase->query(area.left, area.top, right, bottom, [&](const ColliderBounds &found) {
+            ColliderBounds current;
+            if (currentBounds(found.entity, current)) {
+                collect(current);
+            }
+        });
+    }
+    return results.size();
+}
+
+std::size_t SpatialIndex::queryRadius(sf::Vector2f centre, float radius, std::vector<ex::Entity> &results) const {
+    results.clear();
+    float radiusSquared = radius * radius;
+    float left = centre.x - radius, top = centre.y - radius, right = centre.x + radius, bottom = centre.y + radius;
+    auto collect = [&](const ColliderBounds &b) {
+        if (distanceSquared(centre, b) <= radiusSquared) {
+            results.push_back(b.entity);
+        }
+    };
+    points.query(left, top, right, bottom, collect);
+    if (collision) {
+        collision->getStaticTree().query(left, top, right, bottom, collect);
+        collision->broadphase->query(left, top, right, bottom, [&](const ColliderBounds &found) {
+            ColliderBounds current;
+            if (currentBounds(found.entity, current)) {
+                collect(current);
+            }
+        });
+    }
+    return results.size();
+}
+
+bool SpatialIndex::raycast(sf::Vector2f origin, sf::Vector2f direction, float maxDistance, RaycastHit &hit,
+    cmn::CollisionMask layers) const {
+
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    if (!collision || length == 0.0f || maxDistance <= 0.0f) {
+        return false;
+    }
+    sf::Vector2f delta = direction * (maxDistance / length);
+
+    bool found = false;
+    float closest = 1.0f;
+    auto test = [&](const ColliderBounds &b) {
+        float fraction;
+        if ((b.layers & layers) && intersect(origin, delta, b, closest, fraction)) {
+            found = true;
+            closest = fraction;
+            hit.entity = b.entity;
+            hit.point = origin + delta * fraction;
+            hit.distance = fraction * maxDistance;
+        }
+    };
+
+    // The static tree is walked along the ray, which shortens the ray for the broadphase
+    collision->getStaticTree().raycast(origin.x, origin.y, origin.x + delta.x, origin.y + delta.y,
+        [&](const ColliderBounds &b, float maxFraction) {
+        test(b);
+        return closest;
+    });
+
+    // The broadphase can only be asked for an area, so check everything around what is left of the ray
+    sf::Vector2f end = origin + delta * closest;
+    collision->broadphase->query(std::min(origin.x, end.x), std::min(origin.y, end.y),
+        std::max(origin.x, end.x), std::max(origin.y, end.y), [&](const ColliderBounds &candidate) {
+        ColliderBounds current;
+        if (currentBounds(candidate.entity, current)) {
+            test(current);
+        }
+    });
+    return found;
+}
+
+void SpatialIndex::receive(const ex::EntityDestroyedEvent &event) {
+    points.remove(event.entity.id());
+}
+
+void SpatialIndex::receive(const ex::ComponentRemovedEvent<Transform> &event) {
+    points.remove(event.entity.id());
+}
+
+float SpatialIndex::distanceSquared(sf::Vector2f point, const ColliderBounds &bounds) {
+    float dx = point.x < bounds.left ? bounds.left - point.x : (point.x > bounds.right ? point.x - bounds.right : 0.0f);
+    float dy = point.y < bounds.top ? bounds.top - point.y : (point.y > bounds.bottom ? point.y - bounds.bottom : 0.0f);
+    return dx * dx + dy * dy;
+}
+
+bool SpatialIndex::currentBounds(ex::Entity entity, ColliderBounds &bounds) {
+    if (!entity.valid()) {
+        return false;
+    }
+    ex::ComponentHandle<Transform> transform = entity.component<Transform>();
+    ex::ComponentHandle<BoxCollider> collider = entity.component<BoxCollider>();
+    if (!transform || !collider) {
+        return false;
+    }
+    bounds = CollisionSystem::getBounds(entity, *transform.get(), *collider.get());
+    return true;
+}
+
+/*
+ * A slab test: the segment is inside the bounds between the latest fraction at which it
+ * enters the extent on either axis and the earliest at which it leaves one.
+ */
+bool SpatialIndex::intersect(sf::Vector2f origin, sf::Vector2f delta, const ColliderBounds &bounds,
+    float maxFraction, float &fraction) {
+
+    float tMin = 0.0f, tMax = maxFraction;
+    const float start[2] = { origin.x, origin.y }, step[2] = { delta.x, delta.y };
+    const float low[2] = { bounds.left, bounds.top }, high[2] = { bounds.right, bounds.bottom };
+    for (int axis = 0; axis < 2; ++axis) {
+        if (step[axis] == 0.0f) {
+            if (start[axis] < low[axis] || start[axis] > high[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float t1 = (low[axis] - start[axis]) / step[axis];
+        float t2 = (high[axis] - start[axis]) / step[axis];
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+    fraction = tMin;
+    return true;
+}
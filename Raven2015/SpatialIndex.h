@@ -0,0 +1,189 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include <algorithm>            // For std::push_heap, std::pop_heap, std::sort_heap
+#include <limits>               // For std::numeric_limits
+#include <utility>              // For std::pair
+#include <vector>               // For std::vector
+#include "entityx\Entity.h"     // For ex::Entity, ex::EntityManager
+#include "entityx\Event.h"      // For ex::Receiver
+#include "SFML/Graphics.hpp"    // For sf::Vector2f, sf::FloatRect
+#include "Common.h"             // For cmn::CollisionMask
+#include "ComponentLibrary.h"   // For Transform, BoxCollider
+#include "CollisionSystem.h"    // For CollisionSystem, Broadphase
+#include "AABBTree.h"           // For AABBTree
+
+namespace Raven {
+
+    // The closest collider found by a raycast
+    struct RaycastHit {
+        ex::Entity entity;
+
+        // Where the ray enters the collider
+        sf::Vector2f point;
+
+        // How far along the ray the collider was hit
+        float distance;
+    };
+
+    /*
+     * Answers "what is near X" without walking every entity. Colliders are looked up in the
+     * CollisionSystem's own structures, dynamic ones in its broadphase and fixed ones in its
+     * static tree, so they are not indexed twice. Only entities with a Transform but no
+     * BoxCollider are kept here, by position, in an AABB tree with fattened leaves.
+     *
+     * The broadphase learns where colliders are when CollisionSystem::update runs, at the end of
+     * each tick, so colliders are found near where they were then and are checked against their
+     * current bounds. Systems running before the CollisionSystem therefore see the world as it
+     * was when the tick began: moves made earlier in the same tick, and colliders created since
+     * the last update, are not taken into account. In edit mode, CollisionSystem::updateBounds
+     * keeps the colliders current instead.
+     *
+     * Queries write into caller-provided buffers, which are cleared first, so they do not
+     * allocate once the buffers have grown. Queries are meant for the simulation thread and
+     * must not overlap CollisionSystem::update.
+     */
+    class SpatialIndex : public ex::Receiver<SpatialIndex> {
+    public:
+        explicit SpatialIndex(float margin = cmn::STD_UNITX * 0.25f) : collision(nullptr), points(margin) {}
+
+        // Subscribes to the events that take entities out of the index and sets the colliders to query
+        void configure(ex::EventManager &events, const CollisionSystem &collision);
+
+        // Brings the index up to date with the positions of the entities without a BoxCollider
+        void update(ex::EntityManager &es);
+
+        // Collects every entity overlapping the area. Returns the number found.
+        std::size_t queryAABB(const sf::FloatRect &area, std::vector<ex::Entity> &results) const;
+
+        // Collects every entity within the radius of the centre. Returns the number found.
+        std::size_t queryRadius(sf::Vector2f centre, float radius, std::vector<ex::Entity> &results) const;
+
+        /*
+         * Finds the first collider on one of the given layers that the ray hits within
+         * maxDistance. Entities without a BoxCollider cannot be hit. Returns whether there was a hit.
+         */
+        bool raycast(sf::Vector2f origin, sf::Vector2f direction, float maxDistance, RaycastHit &hit,
+            cmn::CollisionMask layers = ~cmn::CollisionMask(0)) const;
+
+        /*
+         * Collects the (at most) k entities with a C component closest to the point, closest
+         * first. The ignored entity, e.g. the one asking, is skipped. Returns the number found.
+         */
+        template <typename C>
+        std::size_t nearest(sf::Vector2f point, std::size_t k, std::vector<ex::Entity> &results,
+            ex::Entity ignore = ex::Entity()) const;
+
+        void receive(const ex::EntityDestroyedEvent &event);
+
+        void receive(const ex::ComponentRemovedEvent<Transform> &event);
+
+        // The tree holding the entities without a BoxCollider
+        const AABBTree &getPointTree() const { return points; }
+
+    private:
+        // The squared distance from a point to the bounds (0 inside the bounds)
+        static float distanceSquared(sf::Vector2f point, const ColliderBounds &bounds);
+
+        // The current bounds of a collider found in the broadphase. Returns false if it has lost its BoxCollider.
+        static bool currentBounds(ex::Entity entity, ColliderBounds &bounds);
+
+        /*
+         * Clips the segment from origin to origin + delta against the bounds. Returns whether it
+         * enters them no later than maxFraction, setting fraction to where it does.
+         */
+        static bool intersect(sf::Vector2f origin, sf::Vector2f delta, const ColliderBounds &bounds,
+            float maxFraction, float &fraction);
+
+        // The system whose broadphase and static tree hold the colliders
+        const CollisionSystem *collision;
+
+        // The entities without a BoxCollider, by position
+        AABBTree points;
+
+        // Scratch storage for the IDs of the indexed entities, used when cleaning up the tree
+        std::vector<std::uint64_t> currentIds;
+
+        // The candidates of a nearest() query as a max-heap on their squared distance
+        mutable std::vector<std::pair<float, ex::Entity>> candidates;
+    };
+
+    template <typename C>
+    std::size_t SpatialIndex::nearest(sf::Vector2f point, std::size_t k, std::vector<ex::Entity> &results,
+        ex::Entity ignore) const {
+
+        results.clear();
+        candidates.clear();
+        if (k == 0) {
+            return 0;
+        }
+
+        auto farther = [](const std::pair<float, ex::Entity> &a, const std::pair<float, ex::Entity> &b) {
+            return a.first < b.first;
+        };
+
+        // Offers an entity at the given squared distance. Returns the distance of the k-th closest so far.
+        auto consider = [&](ex::Entity entity, float distance) {
+            bool full = candidates.size() == k;
+            if (entity != ignore && entity.has_component<C>() && (!full || distance < candidates.front().first)) {
+                if (full) {
+                    std::pop_heap(candidates.begin(), candidates.end(), farther);
+                    candidates.pop_back();
+                }
+                candidates.push_back(std::make_pair(distance, entity));
+                std::push_heap(candidates.begin(), candidates.end(), farther);
+            }
+            return candidates.size() == k ? candidates.front().first : std::numeric_limits<float>::infinity();
+        };
+        auto visit = [&](const ColliderBounds &bounds, float boxDistance) {
+            return consider(bounds.entity, distanceSquared(point, bounds));
+        };
+        points.nearest(point.x, point.y, visit);
+        if (collision) {
+            collision->getStaticTree().nearest(point.x, point.y, visit);
+
+            // The broadphase has no notion of distance, so it is searched in doubling squares around the
+            // point until the k-th closest lies within the square. Anything touching the previous square
+            // was offered already, and anything outside the square is further away than its half-width.
+            const Broadphase &broadphase = *collision->broadphase;
+            std::size_t seen = 0;
+            float radius = cmn::STD_UNITX, previous = -1.0f;
+            while (seen < broadphase.size() && previous != std::numeric_limits<float>::infinity()) {
+                broadphase.query(point.x - radius, point.y - radius, point.x + radius, point.y + radius,
+                    [&](const ColliderBounds &found) {
+                    if (previous >= 0.0f && found.left <= point.x + previous && point.x - previous <= found.right &&
+                        found.top <= point.y + previous && point.y - previous <= found.bottom) {
+                        return;
+                    }
+                    ++seen;
+                    ColliderBounds current;
+                    if (currentBounds(found.entity, current)) {
+                        consider(found.entity, distanceSquared(point, current));
+                    }
+                });
+                if (candidates.size() == k && candidates.front().first <= radius * radius) {
+                    break;
+                }
+                previous = radius;
+                radius *= 2.0f;
+            }
+        }
+
+        std::sort_heap(candidates.begin(), candidates.end(), farther);
+        for (const auto &candidate : candidates) {
+            results.push_back(candidate.second);
+        }
+        return results.size();
+    }
+
+}
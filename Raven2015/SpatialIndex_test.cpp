@@ -0,0 +1,143 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include <algorithm>                    // For std::count
+#include <vector>                       // For std::vector
+#include "entityx\3rdparty\catch.hpp"   // For TEST_CASE, REQUIRE
+#include "CollisionSystem.h"
+#include "ComponentLibrary.h"           // For Transform, Rigidbody, BoxCollider
+#include "SpatialIndex.h"
+
+using namespace Raven;
+
+namespace {
+    const cmn::EBroadphase broadphases[] = {
+        cmn::EBroadphase::SPATIAL_HASH, cmn::EBroadphase::SWEEP_AND_PRUNE, cmn::EBroadphase::AABB_TREE
+    };
+
+    ex::Entity createCollider(ex::EntityManager &entities, float x, float y, float size, cmn::CollisionMask settings) {
+        ex::Entity entity = entities.create();
+        entity.assign<Transform>(x, y);
+        entity.assign<Rigidbody>();
+        entity.assign<BoxCollider>(size, size, 0.0f, 0.0f)->collisionSettings = settings;
+        return entity;
+    }
+
+    // Whether the entity appears exactly once in the results
+    bool foundOnce(const std::vector<ex::Entity> &results, ex::Entity entity) {
+        return std::count(results.begin(), results.end(), entity) == 1;
+    }
+}
+
+TEST_CASE("TestSpatialIndexQueriesCollisionStructures") {
+    for (cmn::EBroadphase broadphase : broadphases) {
+        ex::EventManager events;
+        ex::EntityManager entities(events);
+        CollisionSystem system(broadphase);
+        SpatialIndex index;
+        index.configure(events, system);
+
+        // A large dynamic collider spanning many hash cells, a fixed one, and an entity without a collider
+        ex::Entity dynamic = createCollider(entities, 0.0f, 0.0f, 200.0f, cmn::CollisionInformation::SOLID);
+        ex::Entity fixed = createCollider(entities, 300.0f, 0.0f, 10.0f,
+            cmn::CollisionInformation::SOLID | cmn::CollisionInformation::FIXED);
+        ex::Entity point = entities.create();
+        point.assign<Transform>(600.0f, 0.0f);
+
+        // Enough colliders elsewhere that the hash looks in its cells rather than checking every collider
+        for (int i = 0; i < 100; ++i) {
+            createCollider(entities, i * 20.0f, 5000.0f, 10.0f, cmn::CollisionInformation::SOLID);
+        }
+
+        system.update(entities, events, 0.0);
+        index.update(entities);
+
+        std::vector<ex::Entity> results;
+        REQUIRE(3 == index.queryAABB(sf::FloatRect(-150.0f, -150.0f, 800.0f, 300.0f), results));
+        REQUIRE(foundOnce(results, dynamic));
+        REQUIRE(foundOnce(results, fixed));
+        REQUIRE(foundOnce(results, point));
+
+        REQUIRE(1 == index.queryRadius(sf::Vector2f(110.0f, 0.0f), 15.0f, results));
+        REQUIRE(results[0] == dynamic);
+
+        // A point inside a collider is at no distance from it
+        REQUIRE(1 == index.nearest<Rigidbody>(sf::Vector2f(0.0f, 0.0f), 1, results));
+        REQUIRE(results[0] == dynamic);
+
+        // The point entity is closest, then the fixed collider
+        REQUIRE(2 == index.nearest<Transform>(sf::Vector2f(500.0f, 0.0f), 2, results));
+        REQUIRE(results[0] == point);
+        REQUIRE(results[1] == fixed);
+
+        // The fixed collider is in front of the dynamic one
+        RaycastHit hit;
+        REQUIRE(index.raycast(sf::Vector2f(400.0f, 0.0f), sf::Vector2f(-1.0f, 0.0f), 1000.0f, hit));
+        REQUIRE(hit.entity == fixed);
+        REQUIRE(hit.distance == Approx(95.0f));
+        REQUIRE(index.raycast(sf::Vector2f(200.0f, 0.0f), sf::Vector2f(-1.0f, 0.0f), 1000.0f, hit));
+        REQUIRE(hit.entity == dynamic);
+        REQUIRE(hit.distance == Approx(100.0f));
+    }
+}
+
+TEST_CASE("TestSpatialIndexFindsFarAwayNearestCollider") {
+    for (cmn::EBroadphase broadphase : broadphases) {
+        ex::EventManager events;
+        ex::EntityManager entities(events);
+        CollisionSystem system(broadphase);
+        SpatialIndex index;
+        index.configure(events, system);
+
+        // Far beyond the first squares searched around the point
+        ex::Entity farther = createCollider(entities, 5000.0f, 0.0f, 10.0f, cmn::CollisionInformation::SOLID);
+        ex::Entity closer = createCollider(entities, 0.0f, 3000.0f, 10.0f, cmn::CollisionInformation::SOLID);
+
+        system.update(entities, events, 0.0);
+        index.update(entities);
+
+        std::vector<ex::Entity> results;
+        REQUIRE(1 == index.nearest<Rigidbody>(sf::Vector2f(0.0f, 0.0f), 1, results));
+        REQUIRE(results[0] == closer);
+        REQUIRE(2 == index.nearest<Rigidbody>(sf::Vector2f(0.0f, 0.0f), 5, results));
+        REQUIRE(results[1] == farther);
+        REQUIRE(1 == index.nearest<Rigidbody>(sf::Vector2f(0.0f, 0.0f), 1, results, closer));
+        REQUIRE(results[0] == farther);
+    }
+}
+
+TEST_CASE("TestSpatialIndexSeesRewoundSweptCollider") {
+    ex::EventManager events;
+    ex::EntityManager entities(events);
+    CollisionSystem system;
+    SpatialIndex index;
+    index.configure(events, system);
+
+    // As in TestSweptColliderStopsAtFixedColliderCreatedAfterIt, the mover ends up rewound to x = 44
+    ex::Entity mover = entities.create();
+    mover.assign<Transform>(100.0f, 0.0f);
+    mover.assign<Rigidbody>(100.0f, 0.0f);
+    mover.assign<BoxCollider>(10.0f, 10.0f, 0.0f, 0.0f)->collisionSettings =
+        cmn::CollisionInformation::SOLID | cmn::CollisionInformation::CONTINUOUS;
+    ex::Entity wall = entities.create();
+    wall.assign<Transform>(50.0f, 0.0f);
+    wall.assign<BoxCollider>(2.0f, 100.0f, 0.0f, 0.0f)->collisionSettings =
+        cmn::CollisionInformation::SOLID | cmn::CollisionInformation::FIXED;
+
+    system.update(entities, events, 0.0);
+    index.update(entities);
+
+    // Found where it was rewound to, not where the tick left it
+    std::vector<ex::Entity> results;
+    REQUIRE(1 == index.queryRadius(sf::Vector2f(44.0f, 0.0f), 1.0f, results));
+    REQUIRE(results[0] == mover);
+    REQUIRE(0 == index.queryRadius(sf::Vector2f(100.0f, 0.0f), 1.0f, results));
+}
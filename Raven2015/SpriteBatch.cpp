@@ -0,0 +1,68 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include "SpriteBatch.h"
+
+using namespace Raven;
+
+void SpriteBatch::clear() {
+    batches.clear();
+    vertices.clear();
+}
+
+void SpriteBatch::add(const Renderable &renderable) {
+    if (!renderable.drawPtr) {
+        return;
+    }
+
+    const sf::Sprite *sprite = dynamic_cast<const sf::Sprite*>(renderable.drawPtr);
+    if (!sprite) {
+        batches.push_back(Batch{ nullptr, renderable.drawPtr, 0, 0 });
+    }
+    else if (sprite->getTexture()) { // Sprites without a texture draw nothing, as in sf::Sprite::draw
+        addSprite(*sprite);
+    }
+}
+
+void SpriteBatch::addSprite(const sf::Sprite &sprite) {
+    const sf::Texture *texture = sprite.getTexture();
+    if (batches.empty() || batches.back().drawable || batches.back().texture != texture) {
+        batches.push_back(Batch{ texture, nullptr, vertices.size(), 0 });
+    }
+
+    // The same corners and texture coordinates sf::Sprite uses, moved by the sprite's transform
+    const sf::IntRect &rect = sprite.getTextureRect();
+    const sf::FloatRect bounds = sprite.getLocalBounds();
+    const sf::Transform &transform = sprite.getTransform();
+    const sf::Color color = sprite.getColor();
+    float left = float(rect.left);
+    float right = left + rect.width;
+    float top = float(rect.top);
+    float bottom = top + rect.height;
+
+    vertices.push_back(sf::Vertex(transform.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top)));
+    vertices.push_back(sf::Vertex(transform.transformPoint(bounds.width, 0.f), color, sf::Vector2f(right, top)));
+    vertices.push_back(sf::Vertex(transform.transformPoint(bounds.width, bounds.height), color, sf::Vector2f(right, bottom)));
+    vertices.push_back(sf::Vertex(transform.transformPoint(0.f, bounds.height), color, sf::Vector2f(left, bottom)));
+    batches.back().vertexCount += 4;
+}
+
+void SpriteBatch::draw(Canvas &canvas) const {
+    for (const Batch &batch : batches) {
+        if (batch.drawable) {
+            canvas.Draw(*batch.drawable);
+        }
+        else {
+            canvas.Draw(&vertices[batch.firstVertex], (unsigned int)batch.vertexCount, sf::Quads,
+                sf::RenderStates(batch.texture));
+        }
+    }
+}
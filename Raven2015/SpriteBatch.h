@@ -0,0 +1,66 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include <cstddef>              // For std::size_t
+#include <vector>               // For std::vector
+#include "SFML/Graphics.hpp"    // For sf::Vertex, sf::Sprite, sf::Texture
+#include "SFGUI/Canvas.hpp"     // For sfg::Canvas
+#include "DataAssetLibrary.h"   // For Renderable
+
+namespace Raven {
+
+    /*
+     * Collects a frame's Renderables in draw order and turns every run of sprites sharing a
+     * texture into a single list of quads, so the run costs one draw call instead of one per
+     * sprite. Anything else (text, shapes) is drawn on its own between the runs.
+     *
+     * The draw order is kept exactly. RenderList orders sprites of equal layer and priority by
+     * texture, so that they form runs.
+     */
+    class SpriteBatch {
+    public:
+        // Discards the previous frame's batches while keeping their storage
+        void clear();
+
+        // Appends a Renderable, in draw order
+        void add(const Renderable &renderable);
+
+        // Submits every batch to the canvas, one draw call each
+        void draw(Canvas &canvas) const;
+
+        // The number of draw calls draw() makes for the current frame
+        std::size_t getDrawCalls() const { return batches.size(); }
+
+        // The number of sprites merged into quad batches for the current frame
+        std::size_t getSpriteCount() const { return vertices.size() / 4; }
+
+    private:
+        // A single draw call: a range of quads sharing a texture, or a drawable of another kind
+        struct Batch {
+            const sf::Texture *texture;
+            const sf::Drawable *drawable;
+            std::size_t firstVertex;
+            std::size_t vertexCount;
+        };
+
+        // Appends the quad of a sprite, starting a new batch if its texture differs from the last one
+        void addSprite(const sf::Sprite &sprite);
+
+        // The draw calls of the frame, in order
+        std::vector<Batch> batches;
+
+        // The quads of every sprite batch, four vertices each, in batch order
+        std::vector<sf::Vertex> vertices;
+    };
+
+}
@@ -0,0 +1,161 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include "SweepAndPrune.h"
+#include <algorithm>            // For std::sort, std::remove_if, std::lower_bound, std::max
+
+using namespace Raven;
+
+void SweepAndPrune::update(const std::vector<ColliderBounds> &bounds) {
+    ++tick;
+    std::size_t insertedEndpoints = 0;
+    maxWidth = 0.0f;
+
+    // Refresh the proxies of known colliders and create proxies for new ones
+    for (const ColliderBounds &b : bounds) {
+        maxWidth = std::max(maxWidth, b.right - b.left);
+        auto it = proxyByEntity.find(b.entity.id().id());
+        if (it != proxyByEntity.end()) {
+            Proxy &proxy = proxies[it->second];
+            proxy.bounds = b;
+            proxy.lastSeen = tick;
+            continue;
+        }
+
+        std::uint32_t index;
+        if (!freeProxies.empty()) {
+            index = freeProxies.back();
+            freeProxies.pop_back();
+        }
+        else {
+            index = (std::uint32_t)proxies.size();
+            proxies.push_back(Proxy());
+        }
+        proxies[index].bounds = b;
+        proxies[index].lastSeen = tick;
+        proxies[index].alive = true;
+        proxyByEntity[b.entity.id().id()] = index;
+
+        Endpoint minPoint = { b.left, index, false };
+        Endpoint maxPoint = { b.right, index, true };
+        endpoints.push_back(minPoint);
+        endpoints.push_back(maxPoint);
+        insertedEndpoints += 2;
+    }
+
+    // Release the proxies of colliders that were not reported this tick
+    bool removed = false;
+    for (std::uint32_t index = 0; index < proxies.size(); ++index) {
+        Proxy &proxy = proxies[index];
+        if (proxy.alive && proxy.lastSeen != tick) {
+            proxy.alive = false;
+            proxyByEntity.erase(proxy.bounds.entity.id().id());
+            freeProxies.push_back(index);
+            removed = true;
+        }
+    }
+    if (removed) {
+        endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(), [this](const Endpoint &e) {
+            return !proxies[e.proxy].alive;
+        }), endpoints.end());
+    }
+
+    // Pull the new extents into the endpoint array before re-sorting
+    for (Endpoint &e : endpoints) {
+        const ColliderBounds &b = proxies[e.proxy].bounds;
+        e.value = e.isMax ? b.right : b.left;
+    }
+
+    sortEndpoints(insertedEndpoints);
+}
+
+/*
+ * The endpoints are nearly sorted from the previous tick, so an insertion sort only has to
+ * shuffle the few endpoints that actually crossed each other. A level load, however, appends
+ * everything at once and would make the insertion sort quadratic, so large batches of new
+ * endpoints fall back to a full sort.
+ */
+void SweepAndPrune::sortEndpoints(std::size_t insertedEndpoints) {
+    if (insertedEndpoints > endpoints.size() / 8) {
+        std::sort(endpoints.begin(), endpoints.end());
+        return;
+    }
+
+    for (std::size_t i = 1; i < endpoints.size(); ++i) {
+        Endpoint key = endpoints[i];
+        std::size_t j = i;
+        while (j > 0 && key < endpoints[j - 1]) {
+            endpoints[j] = endpoints[j - 1];
+            --j;
+        }
+        endpoints[j] = key;
+    }
+}
+
+/*
+ * Each pair is reported by whichever of its colliders has the earlier min endpoint: scanning
+ * forward from that endpoint, the other collider's min endpoint appears before the scanning
+ * collider's own max endpoint. Partitions own every partitionCount-th endpoint position, which
+ * keeps crowded stretches of the axis spread over all of them.
+ */
+void SweepAndPrune::findPairs(std::vector<EntityPair> &pairs, std::size_t partition,
+    std::size_t partitionCount) const {
+
+    for (std::size_t position = partition; position < endpoints.size(); position += partitionCount) {
+        const Endpoint &start = endpoints[position];
+        if (start.isMax) {
+            continue;
+        }
+
+        const ColliderBounds &entering = proxies[start.proxy].bounds;
+        for (std::size_t next = position + 1; next < endpoints.size(); ++next) {
+            const Endpoint &e = endpoints[next];
+            if (e.isMax) {
+                // The collider's extent has ended, so it can no longer overlap anything further right
+                if (e.proxy == start.proxy) {
+                    break;
+                }
+                continue;
+            }
+
+            // The other collider starts within this one's x-extent, so only the y-axis remains
+            const ColliderBounds &b = proxies[e.proxy].bounds;
+            if (!entering.canCollide(b) || !entering.overlaps(b)) {
+                continue;
+            }
+            if (b.entity.id().index() < entering.entity.id().index()) {
+                pairs.push_back(std::make_pair(b.entity, entering.entity));
+            }
+            else {
+                pairs.push_back(std::make_pair(entering.entity, b.entity));
+            }
+        }
+    }
+}
+
+/*
+ * No collider is wider than maxWidth, so only those whose min endpoint lies between
+ * left - maxWidth and right can reach the area. A binary search finds the first of them.
+ */
+void SweepAndPrune::queryBounds(float left, float top, float right, float bottom, QueryVisitor &visitor) const {
+    Endpoint first = { left - maxWidth, 0, false };
+    for (auto it = std::lower_bound(endpoints.begin(), endpoints.end(), first);
+        it != endpoints.end() && it->value <= right; ++it) {
+
+        if (it->isMax) {
+            continue;
+        }
+        const ColliderBounds &b = proxies[it->proxy].bounds;
+        if (left <= b.right && b.top <= bottom && top <= b.bottom) {
+            visitor.visit(b);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include <cstdint>              // For std::uint32_t, std::uint64_t
+#include <unordered_map>        // For std::unordered_map
+#include "Broadphase.h"         // For Broadphase, ColliderBounds
+
+namespace Raven {
+
+    /*
+     * A sweep-and-prune broadphase along the x-axis. The min/max x-extents of every collider
+     * are kept sorted between ticks and repaired with an insertion sort, which is close to
+     * linear when colliders only move a few pixels per tick. The sorted endpoints are split
+     * into interleaved intervals when searching for pairs in partitions.
+     */
+    class SweepAndPrune : public Broadphase {
+    public:
+        explicit SweepAndPrune() {}
+
+        // Refreshes existing proxies, adds new colliders and drops those that disappeared
+        void update(const std::vector<ColliderBounds> &bounds) override;
+
+        using Broadphase::findPairs;
+
+        // Scans forward from the min endpoints assigned to the partition, testing the y-axis
+        // of every collider whose extent starts before the scanned collider's extent ends
+        void findPairs(std::vector<EntityPair> &pairs, std::size_t partition,
+            std::size_t partitionCount) const override;
+
+        std::size_t size() const override { return proxyByEntity.size(); }
+
+    protected:
+        // Scans the min endpoints of every collider wide enough to reach the area
+        void queryBounds(float left, float top, float right, float bottom, QueryVisitor &visitor) const override;
+
+    private:
+        // One end of a collider's extent along the x-axis
+        struct Endpoint {
+            // The x-coordinate of the endpoint (cached from its proxy for cache-friendly sorting)
+            float value;
+            // Index of the owning proxy in proxies
+            std::uint32_t proxy;
+            // Whether this is the right (max) end of the extent
+            bool isMax;
+
+            // Minimums sort before maximums at equal values so that touching colliders still pair up
+            bool operator < (const Endpoint &other) const {
+                return value < other.value || (value == other.value && !isMax && other.isMax);
+            }
+        };
+
+        // A persistent record of one collider
+        struct Proxy {
+            ColliderBounds bounds;
+            // The tick in which the proxy was last refreshed
+            std::uint32_t lastSeen;
+            // Whether the proxy slot is in use
+            bool alive;
+        };
+
+        // Repairs the ordering of the endpoints after values have changed
+        void sortEndpoints(std::size_t insertedEndpoints);
+
+        // Persistent proxies, indexed by Endpoint::proxy
+        std::vector<Proxy> proxies;
+
+        // Proxy slots released by removed colliders
+        std::vector<std::uint32_t> freeProxies;
+
+        // Maps an entity ID to the index of its proxy
+        std::unordered_map<std::uint64_t, std::uint32_t> proxyByEntity;
+
+        // The x-extents of every proxy, kept sorted across ticks
+        std::vector<Endpoint> endpoints;
+
+        // Incremented on every update, used to detect colliders that no longer exist
+        std::uint32_t tick = 0;
+
+        // The width of the widest collider of the current tick
+        float maxWidth = 0.0f;
+    };
+
+}
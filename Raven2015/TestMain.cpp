@@ -0,0 +1,16 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+
+// The Raven2015Tests project's only main(); the *_test.cpp files just declare test cases
+#define CATCH_CONFIG_MAIN
+
+#include "entityx\3rdparty\catch.hpp"
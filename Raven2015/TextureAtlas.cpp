@@ -0,0 +1,377 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#include "TextureAtlas.h"
+#include <algorithm>            // For std::stable_sort, std::max
+#include <cstdio>               // For std::remove
+#include <cstdlib>              // For std::strtoull
+#include <fstream>              // For std::ifstream
+#include <iomanip>              // For std::setw, std::setfill
+#include <sstream>              // For std::ostringstream
+#include <sys/stat.h>           // For stat
+#include "Common.h"             // For cmn::BORDER_PADDING, cmn::SHAPE_PADDING, XMLDocument
+
+using namespace Raven;
+
+namespace {
+    const std::uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    const std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+    // Mixes bytes into a 64-bit FNV-1a hash
+    void mixHash(std::uint64_t &hash, const char *data, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= FNV_PRIME;
+        }
+    }
+
+    void mixHash(std::uint64_t &hash, const std::string &text) {
+        // Include the terminator so that consecutive strings cannot run into each other
+        mixHash(hash, text.c_str(), text.size() + 1);
+    }
+
+    // Formats a hash as it appears in the cache's file names
+    std::string toHex(std::uint64_t hash) {
+        std::ostringstream text;
+        text << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return text.str();
+    }
+
+    // Describes a file by its size and modification time, as recorded in the stamp
+    bool getFileStamp(const std::string &path, std::string &size, std::string &modified) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            return false;
+        }
+        size = std::to_string((long long)info.st_size);
+        modified = std::to_string((long long)info.st_mtime);
+        return true;
+    }
+}
+
+bool TextureAtlas::load(const std::set<std::string> &textureFilePaths) {
+    bool stamped = updateHash(textureFilePaths);
+    regions.clear();
+    pages.clear();
+
+    std::vector<sf::Image> images;
+    bool complete = true;
+    if (readCache(images)) {
+        // Hashed the textures in full, so stamp them to skip that next time
+        if (!stamped) {
+            writeStamp(textureFilePaths);
+        }
+    }
+    else {
+        cout << "Packing " << textureFilePaths.size() << " textures into the texture atlas..." << endl;
+        complete = packImages(textureFilePaths, images);
+
+        // Textures that failed to load are packed again next time rather than cached as missing
+        if (complete && !writeCache(textureFilePaths, images)) {
+            cerr << "Warning: Failed to cache the texture atlas in " + cacheDirectory << endl;
+        }
+    }
+
+    for (std::size_t i = 0; i < images.size(); ++i) {
+        pages.push_back(std::unique_ptr<sf::Texture>(new sf::Texture()));
+        if (!pages.back()->loadFromImage(images[i])) {
+            cerr << "Warning: Failed to create texture atlas page " << i << endl;
+            complete = false;
+        }
+    }
+    return complete;
+}
+
+bool TextureAtlas::pack(const std::set<std::string> &textureFilePaths) {
+    bool stamped = updateHash(textureFilePaths);
+    if (std::ifstream(getCachePath(-1).c_str()).good()) {
+        return stamped || writeStamp(textureFilePaths);
+    }
+
+    regions.clear();
+    std::vector<sf::Image> images;
+    if (!packImages(textureFilePaths, images)) {
+        return false;
+    }
+    if (!writeCache(textureFilePaths, images)) {
+        cerr << "Warning: Failed to cache the texture atlas in " + cacheDirectory << endl;
+        return false;
+    }
+    return true;
+}
+
+const sf::Texture *TextureAtlas::getTexture(const std::string &textureFilePath) const {
+    auto found = regions.find(textureFilePath);
+    if (found == regions.end() || found->second.page >= pages.size()) {
+        return nullptr;
+    }
+    return pages[found->second.page].get();
+}
+
+sf::IntRect TextureAtlas::getRect(const std::string &textureFilePath) const {
+    auto found = regions.find(textureFilePath);
+    return found != regions.end() ? found->second.rect : sf::IntRect();
+}
+
+std::uint64_t TextureAtlas::hashTextures(const std::set<std::string> &textureFilePaths) const {
+    std::uint64_t result = FNV_OFFSET;
+
+    // A change of layout invalidates the cache as surely as a change of texture
+    mixHash(result, getLayout());
+
+    std::vector<char> buffer(1 << 16);
+    for (const std::string &path : textureFilePaths) {
+        mixHash(result, path);
+
+        std::ifstream file(path.c_str(), std::ios::binary);
+        std::uint64_t length = 0;
+        while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
+            mixHash(result, buffer.data(), std::size_t(file.gcount()));
+            length += file.gcount();
+        }
+        mixHash(result, std::to_string(length));
+    }
+    return result;
+}
+
+bool TextureAtlas::updateHash(const std::set<std::string> &textureFilePaths) {
+    if (readStamp(textureFilePaths, hash)) {
+        return true;
+    }
+    hash = hashTextures(textureFilePaths);
+    return false;
+}
+
+std::string TextureAtlas::getLayout() const {
+    return std::to_string(pageSize) + "/" + std::to_string(cmn::BORDER_PADDING) + "/" +
+        std::to_string(cmn::SHAPE_PADDING);
+}
+
+bool TextureAtlas::packImages(const std::set<std::string> &textureFilePaths, std::vector<sf::Image> &images) {
+    const unsigned border = cmn::BORDER_PADDING;
+    const unsigned gap = cmn::SHAPE_PADDING;
+
+    std::vector<std::string> paths(textureFilePaths.begin(), textureFilePaths.end());
+    std::vector<sf::Image> sources(paths.size());
+    std::vector<std::size_t> order;
+    bool complete = true;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (paths[i] == "" || !sources[i].loadFromFile(paths[i])) {
+            cerr << "Warning: Failed to load texture at path: " + paths[i] << endl;
+            complete = false;
+            continue;
+        }
+        order.push_back(i);
+    }
+
+    // Tallest first, so that each shelf wastes little height
+    std::stable_sort(order.begin(), order.end(), [&sources](std::size_t a, std::size_t b) {
+        sf::Vector2u sizeA = sources[a].getSize(), sizeB = sources[b].getSize();
+        return sizeA.y != sizeB.y ? sizeA.y > sizeB.y : sizeA.x > sizeB.x;
+    });
+
+    // The width and height in use on each page, borders included
+    std::vector<sf::Vector2u> extents;
+    unsigned x = 0, y = 0, shelfHeight = 0;
+    bool pageClosed = false;
+    for (std::size_t i : order) {
+        sf::Vector2u size = sources[i].getSize();
+        bool oversized = size.x + 2 * border > pageSize || size.y + 2 * border > pageSize;
+
+        // Move to the next shelf, or the next page, once the texture no longer fits
+        bool newPage = extents.empty() || pageClosed || oversized;
+        if (!newPage && x + size.x + border > pageSize) {
+            x = border;
+            y += shelfHeight + gap;
+            shelfHeight = 0;
+        }
+        if (!newPage && y + size.y + border > pageSize) {
+            newPage = true;
+        }
+        if (newPage) {
+            extents.push_back(sf::Vector2u(0, 0));
+            x = border;
+            y = border;
+            shelfHeight = 0;
+        }
+
+        regions[paths[i]] = AtlasRegion{ extents.size() - 1, sf::IntRect(x, y, size.x, size.y) };
+
+        sf::Vector2u &extent = extents.back();
+        extent.x = std::max(extent.x, x + size.x + border);
+        extent.y = std::max(extent.y, y + size.y + border);
+        x += size.x + gap;
+        shelfHeight = std::max(shelfHeight, size.y);
+
+        // A texture larger than a page keeps its page to itself
+        pageClosed = oversized;
+    }
+
+    // Trim each page to the space in use
+    images.assign(extents.size(), sf::Image());
+    for (std::size_t page = 0; page < extents.size(); ++page) {
+        images[page].create(extents[page].x, extents[page].y, sf::Color::Transparent);
+    }
+    for (std::size_t i : order) {
+        const AtlasRegion &region = regions[paths[i]];
+        images[region.page].copy(sources[i], region.rect.left, region.rect.top);
+    }
+    return complete;
+}
+
+bool TextureAtlas::readCache(std::vector<sf::Image> &images) {
+    XMLDocument doc;
+    if (doc.LoadFile(getCachePath(-1).c_str()) != XML_NO_ERROR) {
+        return false;
+    }
+    XMLElement* root = doc.FirstChildElement("TextureAtlas");
+    unsigned pageCount = 0;
+    if (!root || root->QueryUnsignedAttribute("Pages", &pageCount) != XML_NO_ERROR) {
+        return false;
+    }
+
+    images.assign(pageCount, sf::Image());
+    for (unsigned page = 0; page < pageCount; ++page) {
+        if (!images[page].loadFromFile(getCachePath(page))) {
+            images.clear();
+            return false;
+        }
+    }
+
+    for (XMLElement* item = root->FirstChildElement("Region"); item; item = item->NextSiblingElement("Region")) {
+        const char* texture = item->Attribute("Texture");
+        unsigned page = 0;
+        sf::IntRect rect;
+        if (!texture ||
+                item->QueryUnsignedAttribute("Page", &page) != XML_NO_ERROR || page >= pageCount ||
+                item->QueryIntAttribute("Left", &rect.left) != XML_NO_ERROR ||
+                item->QueryIntAttribute("Top", &rect.top) != XML_NO_ERROR ||
+                item->QueryIntAttribute("Width", &rect.width) != XML_NO_ERROR ||
+                item->QueryIntAttribute("Height", &rect.height) != XML_NO_ERROR) {
+            regions.clear();
+            images.clear();
+            return false;
+        }
+        regions[texture] = AtlasRegion{ page, rect };
+    }
+    return true;
+}
+
+bool TextureAtlas::writeCache(const std::set<std::string> &textureFilePaths,
+        const std::vector<sf::Image> &images) const {
+    // The pages go first, so that an index on disk always has its pages
+    for (std::size_t page = 0; page < images.size(); ++page) {
+        if (!images[page].saveToFile(getCachePath(int(page)))) {
+            return false;
+        }
+    }
+
+    XMLDocument doc;
+    XMLElement* root = doc.NewElement("TextureAtlas");
+    root->SetAttribute("Pages", unsigned(images.size()));
+    doc.InsertEndChild(root);
+    for (auto &path_region : regions) {
+        XMLElement* item = doc.NewElement("Region");
+        item->SetAttribute("Texture", path_region.first.c_str());
+        item->SetAttribute("Page", unsigned(path_region.second.page));
+        item->SetAttribute("Left", path_region.second.rect.left);
+        item->SetAttribute("Top", path_region.second.rect.top);
+        item->SetAttribute("Width", path_region.second.rect.width);
+        item->SetAttribute("Height", path_region.second.rect.height);
+        root->InsertEndChild(item);
+    }
+    if (doc.SaveFile(getCachePath(-1).c_str()) != XML_NO_ERROR) {
+        return false;
+    }
+
+    // A stamp that cannot be written only costs the next startup a full hash
+    writeStamp(textureFilePaths);
+    return true;
+}
+
+bool TextureAtlas::readStamp(const std::set<std::string> &textureFilePaths, std::uint64_t &stampedHash) const {
+    XMLDocument doc;
+    if (doc.LoadFile(getStampPath().c_str()) != XML_NO_ERROR) {
+        return false;
+    }
+    XMLElement* root = doc.FirstChildElement("TextureAtlasStamp");
+    const char* layout = root ? root->Attribute("Layout") : nullptr;
+    const char* stamp = root ? root->Attribute("Hash") : nullptr;
+    if (!layout || !stamp || layout != getLayout()) {
+        return false;
+    }
+
+    // Every texture must be listed, in order, with its current size and modification time
+    std::string size, modified;
+    auto path = textureFilePaths.begin();
+    for (XMLElement* item = root->FirstChildElement("Texture"); item; item = item->NextSiblingElement("Texture")) {
+        const char* itemPath = item->Attribute("Path");
+        if (path == textureFilePaths.end() || !itemPath || *path != itemPath ||
+                !getFileStamp(*path, size, modified) ||
+                !item->Attribute("Size", size.c_str()) || !item->Attribute("Modified", modified.c_str())) {
+            return false;
+        }
+        ++path;
+    }
+    if (path != textureFilePaths.end()) {
+        return false;
+    }
+
+    stampedHash = std::strtoull(stamp, nullptr, 16);
+    return true;
+}
+
+bool TextureAtlas::writeStamp(const std::set<std::string> &textureFilePaths) const {
+    XMLDocument doc;
+    XMLElement* root = doc.NewElement("TextureAtlasStamp");
+    root->SetAttribute("Hash", toHex(hash).c_str());
+    root->SetAttribute("Layout", getLayout().c_str());
+    doc.InsertEndChild(root);
+
+    std::string size, modified;
+    for (const std::string &path : textureFilePaths) {
+        if (!getFileStamp(path, size, modified)) {
+            return false;
+        }
+        XMLElement* item = doc.NewElement("Texture");
+        item->SetAttribute("Path", path.c_str());
+        item->SetAttribute("Size", size.c_str());
+        item->SetAttribute("Modified", modified.c_str());
+        root->InsertEndChild(item);
+    }
+
+    // Remove the entry the previous stamp named, pages first as they were written first
+    XMLDocument previous;
+    XMLElement* previousRoot = previous.LoadFile(getStampPath().c_str()) == XML_NO_ERROR ?
+        previous.FirstChildElement("TextureAtlasStamp") : nullptr;
+    const char* previousStamp = previousRoot ? previousRoot->Attribute("Hash") : nullptr;
+    if (previousStamp) {
+        std::uint64_t previousHash = std::strtoull(previousStamp, nullptr, 16);
+        if (previousHash != hash) {
+            for (int page = 0; std::remove(getCachePath(previousHash, page).c_str()) == 0; ++page) {}
+            std::remove(getCachePath(previousHash, -1).c_str());
+        }
+    }
+
+    return doc.SaveFile(getStampPath().c_str()) == XML_NO_ERROR;
+}
+
+std::string TextureAtlas::getCachePath(std::uint64_t entryHash, int page) const {
+    std::ostringstream path;
+    path << cacheDirectory << "atlas_" << toHex(entryHash);
+    if (page < 0) {
+        path << ".xml";
+    }
+    else {
+        path << "_" << page << ".png";
+    }
+    return path.str();
+}
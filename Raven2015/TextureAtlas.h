@@ -0,0 +1,126 @@
+/* Classname:   Gaming Platform Frameworks
+ * Project:     Raven
+ * Version:     1.0
+ *
+ * Copyright:   The contents of this document are the property of its creators.
+ *              Reproduction or usage of it without permission is prohibited.
+ *
+ * Owners:      Will Nations
+ *              Hailee Ammons
+ *              Kevin Wang
+ */
+#pragma once
+
+#include <cstddef>              // For std::size_t
+#include <cstdint>              // For std::uint64_t
+#include <map>                  // For std::map
+#include <memory>               // For std::unique_ptr
+#include <set>                  // For std::set
+#include <string>               // For std::string
+#include <vector>               // For std::vector
+#include "SFML/Graphics.hpp"    // For sf::Image, sf::Texture, sf::IntRect
+
+namespace Raven {
+
+    // Where a packed texture lies within the atlas
+    struct AtlasRegion {
+
+        // The index of the atlas page holding the texture
+        std::size_t page;
+
+        // The texture's pixels within that page
+        sf::IntRect rect;
+    };
+
+    /*
+     * Packs every texture referenced by the assets into a few large pages, so that sprites drawn
+     * from different spritesheets share a texture and SpriteBatch can draw them in one call.
+     *
+     * Textures are placed on shelves, tallest first, leaving cmn::BORDER_PADDING pixels along the
+     * edges of each page and cmn::SHAPE_PADDING pixels between textures. A texture too large for a
+     * page is given a page of its own.
+     *
+     * Packed pages are cached on disk under a hash of the textures' paths and contents, so a
+     * startup with unchanged textures only loads the pages back. pack() writes the cache without
+     * creating any sf::Texture, so it can run offline (the editor does so when saving assets).
+     *
+     * A stamp beside the cache records the current hash with each texture's size and modification
+     * time. While those match, the hash is taken from the stamp rather than from reading every
+     * texture. Only the cache entry named by the stamp is kept; writing a new one removes it.
+     */
+    class TextureAtlas {
+    public:
+        explicit TextureAtlas(const std::string &cacheDirectory = "Resources/Atlas/", unsigned pageSize = 2048)
+            : cacheDirectory(cacheDirectory), pageSize(pageSize), hash(0) {}
+
+        /*
+         * Makes the given textures available from the atlas pages, loading them from the cache or
+         * packing (and caching) them if the textures changed. Replaces any previous pages, so
+         * pointers from getTexture() must be reacquired.
+         * Returns false if a texture could not be loaded; the others are still usable.
+         */
+        bool load(const std::set<std::string> &textureFilePaths);
+
+        // Writes the cache for the given textures, if it is not up to date, without loading any pages
+        bool pack(const std::set<std::string> &textureFilePaths);
+
+        // The page holding a texture, or nullptr if the texture is not in the atlas
+        const sf::Texture *getTexture(const std::string &textureFilePath) const;
+
+        // Where a texture lies within its page, or an empty rectangle if it is not in the atlas
+        sf::IntRect getRect(const std::string &textureFilePath) const;
+
+        std::size_t getPageCount() const { return pages.size(); }
+
+        // The hash of the textures most recently loaded or packed
+        std::uint64_t getHash() const { return hash; }
+
+        // Hashes the paths and file contents of the given textures along with the page layout settings
+        std::uint64_t hashTextures(const std::set<std::string> &textureFilePaths) const;
+
+    private:
+        // Packs the given textures into page images, filling in the regions
+        bool packImages(const std::set<std::string> &textureFilePaths, std::vector<sf::Image> &images);
+
+        // Reads the regions and page images cached under the current hash
+        bool readCache(std::vector<sf::Image> &images);
+
+        // Writes the regions and page images under the current hash, then stamps them as current
+        bool writeCache(const std::set<std::string> &textureFilePaths, const std::vector<sf::Image> &images) const;
+
+        // Finds the stamped hash, if the stamp matches the layout and every texture's size and modification time
+        bool readStamp(const std::set<std::string> &textureFilePaths, std::uint64_t &stampedHash) const;
+
+        // Stamps the current hash, removing the cache entry of the hash it supersedes
+        bool writeStamp(const std::set<std::string> &textureFilePaths) const;
+
+        // Sets hash from the stamp if it is still current, or else by hashing the textures. Returns whether the stamp was used.
+        bool updateHash(const std::set<std::string> &textureFilePaths);
+
+        // The page layout settings that a cache entry depends on, besides the textures
+        std::string getLayout() const;
+
+        // The path of the cache's region index (page == -1) or of one of its page images
+        std::string getCachePath(int page) const { return getCachePath(hash, page); }
+        std::string getCachePath(std::uint64_t entryHash, int page) const;
+
+        // The path of the stamp naming the current cache entry
+        std::string getStampPath() const { return cacheDirectory + "atlas.xml"; }
+
+        // The directory holding the cached pages
+        std::string cacheDirectory;
+
+        // The width and height that pages are packed within
+        unsigned pageSize;
+
+        // The hash of the textures the regions were packed from
+        std::uint64_t hash;
+
+        // The region of each texture, by file path
+        std::map<std::string, AtlasRegion> regions;
+
+        // The loaded pages, held by pointer so that sprites' texture pointers stay valid
+        std::vector<std::unique_ptr<sf::Texture>> pages;
+    };
+
+}
@@ -1,6 +1,7 @@
 #include "XMLSystem.h"
 #include "EntityLibrary.h"
 #include "WidgetLibrary.h"
+#include "TextureAtlas.h"
 
 namespace Raven {
 
@@ -626,6 +627,11 @@ namespace Raven {
         }
         else {
             cout << "Assets successfully saved." << endl;
+
+            // Pack the textures now, so that the next startup finds the texture atlas cached
+            if (!TextureAtlas().pack(textureFilePathSet)) {
+                cerr << "WARNING: Texture atlas failed to pack!" << endl;
+            }
             return true;
         }
     }
@@ -695,6 +701,7 @@ namespace Raven {
         else {
             deserializeEntitySet(levelDoc.FirstChildElement(levelFirstChildElement.c_str()), levelOffset, clearEntitiesBeforehand);
             cout << "Level " + getNameFromFilePath(levelFilePath, true) + " successfully loaded. Deserializing..." << endl;
+            cmn::game->events.emit<XMLLevelLoadedEvent>(levelFilePath);
             return true;
         }
     }
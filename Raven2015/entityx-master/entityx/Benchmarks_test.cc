@@ -1,8 +1,10 @@
 #define CATCH_CONFIG_MAIN
 
+#include <functional>
 #include <iostream>
 #include <vector>
 #include "entityx/3rdparty/catch.hpp"
+#include "entityx/help/ThreadPool.h"
 #include "entityx/help/Timer.h"
 #include "entityx/Entity.h"
 
@@ -144,3 +146,155 @@ TEST_CASE_METHOD(BenchmarkFixture, "TestEntityIterationUnpackTwo") {
     (void)e;
   }
 }
+
+struct Velocity : public Component<Velocity> {
+  float x = 0.0f, y = 0.0f;
+};
+
+struct Heading : public Component<Heading> {
+  float x = 1.0f, y = 1.0f;
+};
+
+TEST_CASE_METHOD(BenchmarkFixture, "TestEntityParallelEach") {
+  int count = 10000000;
+  for (int i = 0; i < count; i++) {
+    auto e = em.create();
+    e.assign<Velocity>();
+    e.assign<Heading>();
+  }
+  auto integrate = [](Entity entity, Velocity &velocity, Heading &heading) {
+    velocity.x += heading.x * 0.01f;
+    velocity.y += heading.y * 0.01f;
+  };
+
+  {
+    AutoTimer t;
+    cout << "each() over " << count << " entities, updating one component from another" << endl;
+    em.each<Velocity, Heading>(integrate);
+  }
+  {
+    AutoTimer t;
+    cout << "parallel_each() over " << count << " entities without a pool" << endl;
+    em.parallel_each<Velocity, Heading>(integrate);
+  }
+
+  help::ThreadPool pool;
+  em.set_thread_pool(&pool);
+  {
+    AutoTimer t;
+    cout << "parallel_each() over " << count << " entities on " << pool.size() << " workers and the caller" << endl;
+    em.parallel_each<Velocity, Heading>(integrate);
+  }
+}
+
+TEST_CASE_METHOD(BenchmarkFixture, "TestEachCallableVersusStdFunction") {
+  int count = 1000000;
+  for (int i = 0; i < count; i++) {
+    auto e = em.create();
+    e.assign<Velocity>();
+    e.assign<Heading>();
+  }
+  auto integrate = [](Entity entity, Velocity &velocity, Heading &heading) {
+    velocity.x += heading.x * 0.01f;
+    velocity.y += heading.y * 0.01f;
+  };
+  auto report = [count](const char *path, help::Timer &timer) {
+    cout << path << ": " << timer.elapsed() * 1e9 / count << " ns per entity over " << count << " entities" << endl;
+  };
+
+  {
+    ComponentHandle<Velocity> velocity;
+    ComponentHandle<Heading> heading;
+    help::Timer timer;
+    for (auto e : em.entities_with_components(velocity, heading)) {
+      integrate(e, *velocity.get(), *heading.get());
+    }
+    report("unpacking view", timer);
+  }
+  {
+    std::function<void(Entity, Velocity&, Heading&)> erased = integrate;
+    help::Timer timer;
+    em.each<Velocity, Heading>(erased);
+    report("each() with std::function", timer);
+  }
+  {
+    help::Timer timer;
+    em.each<Velocity, Heading>(integrate);
+    report("each() with a lambda", timer);
+  }
+  {
+    help::Timer timer;
+    em.entities_with_components<Velocity, Heading>().each(integrate);
+    report("View::each() with a lambda", timer);
+  }
+}
+
+TEST_CASE("TestEachByComponentStorage") {
+  // One entity in eight moves; the rest only have a Position
+  int count = 1000000;
+  const char *names[] = {"pools", "archetypes", "sparse sets"};
+  for (ComponentStorage storage : {ComponentStorage::POOLS, ComponentStorage::ARCHETYPES, ComponentStorage::SPARSE_SETS}) {
+    const char *name = names[int(storage)];
+    EventManager ev;
+    EntityManager em(ev, storage);
+    {
+      help::Timer timer;
+      for (int i = 0; i < count; i++) {
+        auto e = em.create();
+        e.assign<Position>();
+        if (i % 8 == 0) {
+          e.assign<Velocity>();
+          e.assign<Heading>();
+        }
+      }
+      cout << name << ": creating " << count << " entities took " << timer.elapsed() << " seconds" << endl;
+    }
+
+    help::Timer timer;
+    for (int pass = 0; pass < 10; ++pass) {
+      em.each<Velocity, Heading>([](Entity entity, Velocity &velocity, Heading &heading) {
+        velocity.x += heading.x * 0.01f;
+        velocity.y += heading.y * 0.01f;
+      });
+    }
+    cout << name << ": each() took " << timer.elapsed() * 1e9 / (10 * count / 8) << " ns per matching entity" << endl;
+  }
+}
+
+TEST_CASE_METHOD(BenchmarkFixture, "TestCachedViewVersusView") {
+  // One entity in a hundred matches
+  int count = 1000000;
+  for (int i = 0; i < count; i++) {
+    auto e = em.create();
+    e.assign<Velocity>();
+    if (i % 100 == 0) e.assign<Heading>();
+  }
+  const int passes = 100;
+  int visited = 0;
+  {
+    help::Timer timer;
+    for (int pass = 0; pass < passes; ++pass) {
+      for (auto e : em.entities_with_components<Velocity, Heading>()) {
+        e.component<Heading>()->x += 1.0f;
+        ++visited;
+      }
+    }
+    cout << "view: " << timer.elapsed() * 1e3 / passes << " ms per pass over " << visited / passes << " entities" << endl;
+  }
+  {
+    help::Timer timer;
+    em.cached_view<Velocity, Heading>();
+    cout << "cached view: registering took " << timer.elapsed() * 1e3 << " ms" << endl;
+  }
+  {
+    help::Timer timer;
+    for (int pass = 0; pass < passes; ++pass) {
+      for (auto e : em.cached_view<Velocity, Heading>()) {
+        e.component<Heading>()->x -= 1.0f;
+        --visited;
+      }
+    }
+    cout << "cached view: " << timer.elapsed() * 1e3 / passes << " ms per pass" << endl;
+  }
+  REQUIRE(0 == visited);
+}
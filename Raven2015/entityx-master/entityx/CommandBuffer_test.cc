@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2012 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <string>
+#include <vector>
+#include "entityx/3rdparty/catch.hpp"
+#include "entityx/CommandBuffer.h"
+#include "entityx/help/ThreadPool.h"
+
+using namespace entityx;
+
+struct Position {
+  explicit Position(float x = 0.0f, float y = 0.0f) : x(x), y(y) {}
+
+  float x, y;
+};
+
+struct Name {
+  explicit Name(const std::string &name = "") : name(name) {}
+
+  std::string name;
+};
+
+// Bigger than an arena block, so it gets an allocation of its own.
+struct Big {
+  char bytes[32768];
+};
+
+struct CommandBufferFixture {
+  EventManager events;
+  EntityManager entities{events};
+  CommandBuffer commands;
+};
+
+
+TEST_CASE_METHOD(CommandBufferFixture, "TestCommandBufferCreatesEntitiesOnPlay") {
+  CommandBuffer::PendingEntity pending = commands.create();
+  commands.assign<Position>(pending, 1.0f, 2.0f);
+  commands.assign<Name>(pending, "pending");
+  REQUIRE(3 == commands.size());
+  REQUIRE(0 == entities.size());
+
+  commands.play(entities);
+  REQUIRE(commands.empty());
+  REQUIRE(1 == entities.size());
+  int count = 0;
+  entities.each<Position, Name>([&](Entity entity, Position &position, Name &name) {
+    REQUIRE(2.0f == position.y);
+    REQUIRE("pending" == name.name);
+    ++count;
+  });
+  REQUIRE(1 == count);
+}
+
+TEST_CASE_METHOD(CommandBufferFixture, "TestCommandBufferAppliesCommandsInOrder") {
+  Entity a = entities.create();
+  Entity b = entities.create();
+  a.assign<Position>(1.0f, 1.0f);
+  b.assign<Name>("b");
+
+  commands.assign<Position>(a.id(), 5.0f, 5.0f);
+  commands.remove<Position>(a.id());
+  commands.assign<Position>(a.id(), 7.0f, 7.0f);
+  commands.remove<Position>(b.id());
+  commands.destroy(b.id());
+  commands.assign<Name>(b.id(), "dropped");
+  commands.destroy(b.id());
+  REQUIRE(a.component<Position>()->x == 1.0f);
+
+  commands.play(entities);
+  REQUIRE(a.valid());
+  REQUIRE(a.component<Position>()->x == 7.0f);
+  REQUIRE(!b.valid());
+  REQUIRE(1 == entities.size());
+}
+
+TEST_CASE_METHOD(CommandBufferFixture, "TestCommandBufferClearAndReuse") {
+  Entity a = entities.create();
+  commands.create();
+  commands.assign<Name>(a.id(), "discarded");
+  commands.assign<Big>(a.id());
+  commands.clear();
+  REQUIRE(commands.empty());
+  commands.play(entities);
+  REQUIRE(1 == entities.size());
+  REQUIRE(!a.has_component<Name>());
+
+  // Enough commands to fill several arena blocks.
+  for (int i = 0; i < 2000; ++i) {
+    commands.assign<Name>(commands.create(), std::to_string(i));
+  }
+  commands.play(entities);
+  REQUIRE(2001 == entities.size());
+  int named = 0;
+  entities.each<Name>([&](Entity entity, Name &name) { ++named; });
+  REQUIRE(2000 == named);
+}
+
+TEST_CASE_METHOD(CommandBufferFixture, "TestCommandBufferRecordsFromManyThreads") {
+  const std::size_t count = 10000;
+  for (std::size_t i = 0; i < count; ++i) {
+    entities.create().assign<Position>(float(i), 0.0f);
+  }
+
+  help::ThreadPool pool(4);
+  entities.set_thread_pool(&pool);
+  entities.parallel_each<Position>([&](Entity entity, Position &position) {
+    if (int(position.x) % 2) {
+      commands.destroy(entity.id());
+    } else {
+      commands.assign<Name>(entity.id(), "even");
+      commands.assign<Position>(commands.create(), position.x, 1.0f);
+    }
+  }, 1000);
+  REQUIRE(commands.size() == 2 * count);
+
+  commands.play(entities);
+  REQUIRE(count == entities.size());
+  std::size_t named = 0, created = 0;
+  entities.each<Position>([&](Entity entity, Position &position) {
+    REQUIRE(0 == int(position.x) % 2);
+    if (entity.has_component<Name>()) ++named;
+    if (position.y == 1.0f) ++created;
+  });
+  REQUIRE(named == count / 2);
+  REQUIRE(created == count / 2);
+}
@@ -27,12 +27,16 @@
 #include <utility>
 #include <vector>
 #include <type_traits>
+#include <unordered_map>
  #include <functional>
 
+#include "entityx/help/Archetype.h"
 #include "entityx/help/Pool.h"
+#include "entityx/help/SparseSet.h"
 #include "entityx/config.h"
 #include "entityx/Event.h"
 #include "entityx/help/NonCopyable.h"
+#include "entityx/help/ThreadPool.h"
 
 namespace entityx {
 
@@ -40,6 +44,7 @@ typedef std::uint32_t uint32_t;
 typedef std::uint64_t uint64_t;
 
 class EntityManager;
+class ComponentAccess;
 
 
 template <typename C, typename EM = EntityManager>
@@ -274,11 +279,58 @@ struct Component : public BaseComponent {
 
 private:
   friend class EntityManager;
+  friend class ComponentAccess;
   /// Used internally for registration.
   static Family family();
 };
 
 
+// The largest power of two no greater than n.
+constexpr std::size_t floor_power_of_two(std::size_t n, std::size_t p = 1) {
+  return p * 2 > n ? p : floor_power_of_two(n, p * 2);
+}
+
+// Components per 64KB, rounded down to a power of two and kept within [64, 8192].
+constexpr std::size_t default_chunk_size(std::size_t element_size) {
+  return floor_power_of_two(65536 / element_size) < 64 ? 64
+      : floor_power_of_two(65536 / element_size) > 8192 ? 8192
+      : floor_power_of_two(65536 / element_size);
+}
+
+
+/**
+ * Storage hints for component type C. Specialise it to tune a component's storage:
+ *
+ *     template <> struct ComponentStorageTraits<Music> { static const std::size_t chunk_size = 8; };
+ *
+ * chunk_size is how many components a Pool or SparseSet allocates at a time. The default
+ * aims for 64KB chunks, from 64 to 8192 components. Rare components want small chunks, as
+ * assigning the first one allocates a whole chunk. Keep it a power of two, so that
+ * EntityManager::parallel_each() chunks line up across pools.
+ */
+template <typename C>
+struct ComponentStorageTraits {
+  static const std::size_t chunk_size = default_chunk_size(sizeof(C));
+};
+
+template <typename C>
+const std::size_t ComponentStorageTraits<C>::chunk_size;
+
+
+/**
+ * Memory held by the storage of one component type. See EntityManager::memory_usage().
+ */
+struct ComponentMemoryUsage {
+  BaseComponent::Family family;
+  /// Components currently assigned.
+  std::size_t count;
+  /// Components that fit without allocating.
+  std::size_t capacity;
+  /// Bytes allocated, including any index the storage keeps.
+  std::size_t bytes;
+};
+
+
 /**
  * Emitted when an entity is added to the system.
  */
@@ -326,6 +378,26 @@ struct ComponentRemovedEvent : public Event<ComponentRemovedEvent<C>> {
 };
 
 
+/**
+ * How an EntityManager lays out components in memory.
+ */
+enum class ComponentStorage {
+  /// One Pool per component type, indexed by entity. Component addresses never change.
+  POOLS,
+  /// One Archetype per distinct set of components, so entities with the same components are
+  /// packed together and each() skips entities without touching them. Assigning or removing a
+  /// component moves the entity's components to another Archetype, and destroying an entity moves
+  /// another one into its place, so raw component pointers do not survive either. ComponentHandles
+  /// do, as they look the component up on every access.
+  ARCHETYPES,
+  /// One SparseSet per component type, holding only the entities that have that component, so
+  /// each() scans the smallest set involved and checks the others in O(1). Removing a component
+  /// or destroying an entity moves the last component of each type involved into its place, so
+  /// raw pointers to those components do not survive it. ComponentHandles do.
+  SPARSE_SETS
+};
+
+
 /**
  * Manages Entity::Id creation and component assignment.
  */
@@ -333,9 +405,11 @@ class EntityManager : entityx::help::NonCopyable {
  public:
   typedef std::bitset<entityx::MAX_COMPONENTS> ComponentMask;
 
-  explicit EntityManager(EventManager &event_manager);
+  explicit EntityManager(EventManager &event_manager, ComponentStorage storage = ComponentStorage::POOLS);
   virtual ~EntityManager();
 
+  ComponentStorage storage() const { return storage_; }
+
   /// An iterator over a view of the entities in an EntityManager.
   /// If All is true it will iterate over all valid entities and will ignore the entity mask.
   template <class Delegate, bool All = false>
@@ -417,7 +491,7 @@ class EntityManager : entityx::help::NonCopyable {
     const Iterator begin() const { return Iterator(manager_, mask_, 0); }
     const Iterator end() const { return Iterator(manager_, mask_, manager_->capacity()); }
 
-  private:
+  protected:
     friend class EntityManager;
 
     explicit BaseView(EntityManager *manager) : manager_(manager) { mask_.set(); }
@@ -438,6 +512,12 @@ class EntityManager : entityx::help::NonCopyable {
         f(it, *(it.template component<Components>().get())...);
     }
 
+    /// As above, but inlines the callable and looks up each component's pool once per call.
+    template <typename F>
+    void each(F f) {
+      this->manager_->template each_<Components...>(this->mask_, f);
+    }
+
   private:
     friend class EntityManager;
 
@@ -511,6 +591,91 @@ class EntityManager : entityx::help::NonCopyable {
     Unpacker unpacker_;
   };
 
+  // The entities matching one component mask, kept up to date by assign(), remove() and
+  // destroy(). Entities are packed; erasing one moves the last into its place.
+  struct Membership {
+    static const uint32_t ABSENT = ~uint32_t(0);
+
+    explicit Membership(const ComponentMask &mask) : mask(mask) {}
+
+    void insert(uint32_t index) {
+      if (index >= positions.size()) positions.resize(index + 1, ABSENT);
+      positions[index] = uint32_t(entities.size());
+      entities.push_back(index);
+    }
+
+    void erase(uint32_t index) {
+      const uint32_t position = positions[index];
+      entities[position] = entities.back();
+      positions[entities[position]] = position;
+      entities.pop_back();
+      positions[index] = ABSENT;
+    }
+
+    ComponentMask mask;
+    std::vector<uint32_t> entities;
+    // Position of each entity in entities, or ABSENT. Index into the vector is the Entity::Id.
+    std::vector<uint32_t> positions;
+  };
+
+  /**
+   * A persistent view of the entities with all of Components. See cached_view().
+   *
+   * Iteration walks the matching entities from the most recently matched one backwards, so an
+   * entity may be destroyed, or have components removed, while it is being visited. Entities that
+   * start matching during the iteration are not visited.
+   */
+  template <typename ... Components>
+  class CachedView {
+   public:
+    class Iterator : public std::iterator<std::input_iterator_tag, Entity> {
+     public:
+      Iterator &operator ++() {
+        --position_;
+        return *this;
+      }
+      bool operator == (const Iterator& rhs) const { return position_ == rhs.position_; }
+      bool operator != (const Iterator& rhs) const { return position_ != rhs.position_; }
+      Entity operator * () const {
+        return Entity(manager_, manager_->create_id(membership_->entities[position_ - 1]));
+      }
+
+     private:
+      friend class CachedView;
+
+      Iterator(EntityManager *manager, const Membership *membership, size_t position)
+          : manager_(manager), membership_(membership), position_(position) {}
+
+      EntityManager *manager_;
+      const Membership *membership_;
+      size_t position_;
+    };
+
+    Iterator begin() { return Iterator(manager_, membership_, membership_->entities.size()); }
+    Iterator end() { return Iterator(manager_, membership_, 0); }
+
+    /// Number of matching entities.
+    size_t size() const { return membership_->entities.size(); }
+
+    /// Call f(Entity, Components&...) for every matching entity, in iteration order.
+    template <typename F>
+    void each(F f) {
+      for (size_t position = membership_->entities.size(); position > 0; --position) {
+        const uint32_t index = membership_->entities[position - 1];
+        Entity entity(manager_, manager_->create_id(index));
+        f(entity, *manager_->template get_component_ptr<Components>(entity.id())...);
+      }
+    }
+
+   private:
+    friend class EntityManager;
+
+    CachedView(EntityManager *manager, Membership *membership) : manager_(manager), membership_(membership) {}
+
+    EntityManager *manager_;
+    Membership *membership_;
+  };
+
   /**
    * Number of managed entities.
    */
@@ -544,6 +709,10 @@ class EntityManager : entityx::help::NonCopyable {
       free_list_.pop_back();
        version = entity_version_[index];
     }
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      const uint32_t archetype = archetype_for_(ComponentMask());
+      entity_location_[index] = EntityLocation{archetype, uint32_t(archetypes_[archetype]->push(index))};
+    }
     Entity entity(this, Entity::Id(index, version));
     event_manager_.emit<EntityCreatedEvent>(entity);
     return entity;
@@ -559,11 +728,24 @@ class EntityManager : entityx::help::NonCopyable {
     uint32_t index = entity.index();
     auto mask = entity_component_mask_[entity.index()];
     event_manager_.emit<EntityDestroyedEvent>(Entity(this, entity));
-    for (size_t i = 0; i < component_pools_.size(); i++) {
-      BasePool *pool = component_pools_[i];
-      if (pool && mask.test(i))
-        pool->destroy(index);
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      const EntityLocation location = entity_location_[index];
+      Archetype &archetype = *archetypes_[location.archetype];
+      archetype.destroy(location.row);
+      entity_location_[archetype.erase(location.row)].row = location.row;
+    } else if (storage_ == ComponentStorage::SPARSE_SETS) {
+      for (size_t i = 0; i < sparse_sets_.size(); i++) {
+        if (mask.test(i))
+          sparse_sets_[i]->erase(index);
+      }
+    } else {
+      for (size_t i = 0; i < component_pools_.size(); i++) {
+        BasePool *pool = component_pools_[i];
+        if (pool && mask.test(i))
+          pool->destroy(index);
+      }
     }
+    if (!memberships_.empty()) update_memberships_(index, entity_component_mask_[index], ComponentMask());
     entity_component_mask_[index].reset();
     entity_version_[index]++;
     free_list_.push_back(index);
@@ -597,12 +779,28 @@ class EntityManager : entityx::help::NonCopyable {
     const BaseComponent::Family family = component_family<C>();
     assert(!entity_component_mask_[id.index()].test(family));
 
-    // Placement new into the component pool.
-    Pool<C> *pool = accomodate_component<C>();
-    new(pool->get(id.index())) C(std::forward<Args>(args) ...);
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      // Move the entity to the archetype with C, then placement new into C's column there.
+      accomodate_component_ops<C>();
+      ComponentMask mask = entity_component_mask_[id.index()];
+      mask.set(family);
+      move_entity_(id.index(), mask);
+      new(get_component_ptr<C>(id)) C(std::forward<Args>(args) ...);
+    } else if (storage_ == ComponentStorage::SPARSE_SETS) {
+      // Placement new at the end of C's packed array.
+      new(accomodate_sparse_set<C>()->insert(id.index())) C(std::forward<Args>(args) ...);
+    } else {
+      // Placement new into the component pool.
+      Pool<C> *pool = accomodate_component<C>();
+      new(pool->get(id.index())) C(std::forward<Args>(args) ...);
+    }
 
     // Set the bit for this component.
     entity_component_mask_[id.index()].set(family);
+    if (!memberships_.empty()) {
+      ComponentMask before = entity_component_mask_[id.index()];
+      update_memberships_(id.index(), before.reset(family), entity_component_mask_[id.index()]);
+    }
 
     // Create and return handle.
     ComponentHandle<C> component(this, id);
@@ -621,16 +819,26 @@ class EntityManager : entityx::help::NonCopyable {
     const BaseComponent::Family family = component_family<C>();
     const uint32_t index = id.index();
 
-    // Find the pool for this component family.
-    BasePool *pool = component_pools_[family];
     ComponentHandle<C> component(this, id);
     event_manager_.emit<ComponentRemovedEvent<C>>(Entity(this, id), component);
 
     // Remove component bit.
     entity_component_mask_[id.index()].reset(family);
+    if (!memberships_.empty()) {
+      ComponentMask before = entity_component_mask_[index];
+      update_memberships_(index, before.set(family), entity_component_mask_[index]);
+    }
 
-    // Call destructor.
-    pool->destroy(index);
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      // Moving to the archetype without C calls its destructor.
+      move_entity_(index, entity_component_mask_[index]);
+    } else if (storage_ == ComponentStorage::SPARSE_SETS) {
+      // Call destructor, moving the last C into its place.
+      sparse_sets_[family]->erase(index);
+    } else {
+      // Call destructor.
+      component_pools_[family]->destroy(index);
+    }
   }
 
   /**
@@ -639,14 +847,8 @@ class EntityManager : entityx::help::NonCopyable {
   template <typename C>
   bool has_component(Entity::Id id) const {
     assert_valid(id);
-    size_t family = component_family<C>();
-    // We don't bother checking the component mask, as we return a nullptr anyway.
-    if (family >= component_pools_.size())
-      return false;
-    BasePool *pool = component_pools_[family];
-    if (!pool || !entity_component_mask_[id.index()][family])
-      return false;
-    return true;
+    // The bit is only ever set once the component's storage exists.
+    return entity_component_mask_[id.index()][component_family<C>()];
   }
 
   /**
@@ -657,12 +859,7 @@ class EntityManager : entityx::help::NonCopyable {
   template <typename C, typename = typename std::enable_if<!std::is_const<C>::value>::type>
   ComponentHandle<C> component(Entity::Id id) {
     assert_valid(id);
-    size_t family = component_family<C>();
-    // We don't bother checking the component mask, as we return a nullptr anyway.
-    if (family >= component_pools_.size())
-      return ComponentHandle<C>();
-    BasePool *pool = component_pools_[family];
-    if (!pool || !entity_component_mask_[id.index()][family])
+    if (!has_component<C>(id))
       return ComponentHandle<C>();
     return ComponentHandle<C>(this, id);
   }
@@ -675,12 +872,7 @@ class EntityManager : entityx::help::NonCopyable {
   template <typename C, typename = typename std::enable_if<std::is_const<C>::value>::type>
   const ComponentHandle<C, const EntityManager> component(Entity::Id id) const {
     assert_valid(id);
-    size_t family = component_family<C>();
-    // We don't bother checking the component mask, as we return a nullptr anyway.
-    if (family >= component_pools_.size())
-      return ComponentHandle<C, const EntityManager>();
-    BasePool *pool = component_pools_[family];
-    if (!pool || !entity_component_mask_[id.index()][family])
+    if (!has_component<C>(id))
       return ComponentHandle<C, const EntityManager>();
     return ComponentHandle<C, const EntityManager>(this, id);
   }
@@ -720,6 +912,134 @@ class EntityManager : entityx::help::NonCopyable {
     return entities_with_components<Components...>().each(f);
   }
 
+  /**
+   * Call f(Entity, Components&...) for every entity with all of the given components.
+   *
+   * Chosen over the std::function overload for lambdas and other callables, so that the
+   * callback can be inlined. The component pools are looked up once per call rather than
+   * once per entity.
+   *
+   * With ComponentStorage::ARCHETYPES, only archetypes with all of the components are visited.
+   * With ComponentStorage::SPARSE_SETS, only the entities in the smallest of the components' sets
+   * are visited. With either, f must not assign or remove components or destroy entities, as that
+   * moves components underneath the iteration.
+   */
+  template <typename ... Components, typename F>
+  void each(F f) {
+    each_<Components...>(component_mask<Components ...>(), f);
+  }
+
+  /**
+   * Like each(), but splits the entity index range into chunks and runs them on the thread pool
+   * set with set_thread_pool(), or serially if there is none.
+   *
+   * Chunks hold grain_size entity indices, rounded up to a whole number of component Pool chunks
+   * (by default, a single Pool chunk), so no two tasks share a block of component memory. With
+   * ComponentStorage::ARCHETYPES or SPARSE_SETS, chunks are instead runs of Archetype chunks, or of
+   * chunks of the smallest SparseSet, holding at least grain_size entities.
+   *
+   * f(Entity, Components&...) runs concurrently with itself: it may only touch the components it
+   * is passed. It must not create or destroy entities, assign or remove components, or emit events;
+   * record such changes in a CommandBuffer and play it once parallel_each() returns.
+   *
+   * @code
+   * entity_manager.parallel_each<Position, Direction>([](Entity entity, Position &position, Direction &direction) {
+   *   position.x += direction.x;
+   * });
+   * @endcode
+   */
+  template <typename ... Components, typename F>
+  void parallel_each(F f, size_t grain_size = 0) {
+    static_assert(sizeof...(Components) > 0, "parallel_each() requires at least one component");
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      parallel_each_archetypes_<Components...>(f, grain_size);
+      return;
+    }
+    if (storage_ == ComponentStorage::SPARSE_SETS) {
+      parallel_each_sparse_sets_<Components...>(f, grain_size);
+      return;
+    }
+    BasePool *pools[] = {component_pool_<Components>()...};
+    size_t chunk_size = 0;
+    for (BasePool *pool : pools) {
+      // No entity can have a component that has never been assigned
+      if (!pool) return;
+      chunk_size = std::max(chunk_size, pool->chunk_size());
+    }
+
+    const ComponentMask mask = component_mask<Components ...>();
+    const size_t grain = std::max<size_t>(1, (grain_size + chunk_size - 1) / chunk_size) * chunk_size;
+    const size_t count = capacity();
+    const size_t chunks = (count + grain - 1) / grain;
+    auto run_chunk = [&](size_t chunk) {
+      each_in_range_<Components...>(mask, pools, chunk * grain, std::min(count, (chunk + 1) * grain), f,
+                                    std::index_sequence_for<Components...>());
+    };
+
+    if (!thread_pool_ || chunks < 2) {
+      for (size_t chunk = 0; chunk < chunks; ++chunk) run_chunk(chunk);
+    } else {
+      thread_pool_->parallel_for(chunks, run_chunk);
+    }
+  }
+
+  /**
+   * Allocate storage for n components of type C up front, for example before loading a level.
+   *
+   * Pools are indexed by entity, so with ComponentStorage::POOLS this covers entity indices below
+   * n. With ComponentStorage::ARCHETYPES, components are stored by archetype, so this only
+   * registers C.
+   */
+  template <typename C>
+  void reserve(size_t n) {
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      accomodate_component_ops<C>();
+    } else if (storage_ == ComponentStorage::SPARSE_SETS) {
+      accomodate_sparse_set<C>()->reserve(n);
+    } else {
+      accomodate_component<C>()->reserve(n);
+    }
+  }
+
+  /**
+   * Report the memory held by the storage of each component type that has been assigned or
+   * reserved, in family order.
+   *
+   * @code
+   * for (const ComponentMemoryUsage &usage : entity_manager.memory_usage()) {
+   *   if (usage.family == EntityManager::component_family<Position>())
+   *     std::cout << usage.bytes << " bytes for " << usage.count << " positions" << std::endl;
+   * }
+   * @endcode
+   */
+  std::vector<ComponentMemoryUsage> memory_usage() const;
+
+  /**
+   * Set the pool on which parallel_each() runs. Without one, parallel_each() runs serially.
+   */
+  void set_thread_pool(help::ThreadPool *pool) { thread_pool_ = pool; }
+  help::ThreadPool *thread_pool() const { return thread_pool_; }
+
+  /**
+   * Like entities_with_components(), but returns a view whose list of matching entities persists
+   * in the EntityManager. The first call for a set of components finds the matching entities;
+   * after that assign(), remove() and destroy() keep the list up to date, so getting the view is
+   * a hash lookup and iterating it visits only matching entities.
+   *
+   * Each registered view adds a little work to every assign(), remove() and destroy(), so use
+   * them for queries that run every frame.
+   *
+   * @code
+   * for (Entity entity : entity_manager.cached_view<Position, Direction>()) {}
+   * entity_manager.cached_view<Position, Direction>().each([](Entity entity, Position &position, Direction &direction) {});
+   * @endcode
+   */
+  template <typename ... Components>
+  CachedView<Components...> cached_view() {
+    static_assert(sizeof...(Components) > 0, "cached_view() requires at least one component");
+    return CachedView<Components...>(this, membership_for_(component_mask<Components ...>()));
+  }
+
   /**
    * Find Entities that have all of the specified Components and assign them
    * to the given parameters.
@@ -800,6 +1120,14 @@ class EntityManager : entityx::help::NonCopyable {
   template <typename C>
   C *get_component_ptr(Entity::Id id) {
     assert(valid(id));
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      const EntityLocation &location = entity_location_[id.index()];
+      Archetype &archetype = *archetypes_[location.archetype];
+      return static_cast<C*>(archetype.get(archetype.column(component_family<C>()), location.row));
+    }
+    if (storage_ == ComponentStorage::SPARSE_SETS) {
+      return static_cast<C*>(sparse_sets_[component_family<C>()]->get(id.index()));
+    }
     BasePool *pool = component_pools_[component_family<C>()];
     assert(pool);
     return static_cast<C*>(pool->get(id.index()));
@@ -808,6 +1136,14 @@ class EntityManager : entityx::help::NonCopyable {
   template <typename C>
   const C *get_component_ptr(Entity::Id id) const {
     assert_valid(id);
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      const EntityLocation &location = entity_location_[id.index()];
+      const Archetype &archetype = *archetypes_[location.archetype];
+      return static_cast<const C*>(archetype.get(archetype.column(component_family<C>()), location.row));
+    }
+    if (storage_ == ComponentStorage::SPARSE_SETS) {
+      return static_cast<const C*>(sparse_sets_[component_family<C>()]->get(id.index()));
+    }
     BasePool *pool = component_pools_[component_family<C>()];
     assert(pool);
     return static_cast<const C*>(pool->get(id.index()));
@@ -844,6 +1180,8 @@ class EntityManager : entityx::help::NonCopyable {
     if (entity_component_mask_.size() <= index) {
       entity_component_mask_.resize(index + 1);
       entity_version_.resize(index + 1);
+      if (storage_ == ComponentStorage::ARCHETYPES)
+        entity_location_.resize(index + 1);
       for (BasePool *pool : component_pools_)
         if (pool) pool->expand(index + 1);
     }
@@ -856,15 +1194,200 @@ class EntityManager : entityx::help::NonCopyable {
       component_pools_.resize(family + 1, nullptr);
     }
     if (!component_pools_[family]) {
-      Pool<C> *pool = new Pool<C>();
+      Pool<C> *pool = new Pool<C>(ComponentStorageTraits<C>::chunk_size);
       pool->expand(index_counter_);
       component_pools_[family] = pool;
     }
     return static_cast<Pool<C>*>(component_pools_[family]);
   }
 
+  template <typename C>
+  void accomodate_component_ops() {
+    BaseComponent::Family family = component_family<C>();
+    if (!component_ops_[family]) {
+      component_ops_[family] = component_ops<C>();
+    }
+  }
+
+  template <typename C>
+  SparseSet *accomodate_sparse_set() {
+    BaseComponent::Family family = component_family<C>();
+    if (sparse_sets_.size() <= family) {
+      sparse_sets_.resize(family + 1);
+    }
+    if (!sparse_sets_[family]) {
+      sparse_sets_[family].reset(new SparseSet(component_ops<C>(), ComponentStorageTraits<C>::chunk_size));
+    }
+    return sparse_sets_[family].get();
+  }
+
+  // Find or create the membership list for a mask.
+  Membership *membership_for_(const ComponentMask &mask);
+
+  // Add or remove an entity from the membership lists whose masks it started or stopped matching.
+  void update_memberships_(uint32_t index, const ComponentMask &before, const ComponentMask &after);
+
+  // Find or create the archetype for a mask, returning its index in archetypes_.
+  uint32_t archetype_for_(const ComponentMask &mask);
+
+  // Move an entity to the archetype for mask, relocating the components it keeps and destroying
+  // the ones mask lacks. Components mask adds are left uninitialised.
+  void move_entity_(uint32_t index, const ComponentMask &mask);
+
+
+  // Calls f for every entity matching the mask, reading the components from the given pools.
+  template <typename ... Components, typename F>
+  void each_(const ComponentMask &mask, F &f) {
+    static_assert(sizeof...(Components) > 0, "each() with a callable requires at least one component");
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      // Iterate by index, as the vector may grow if f assigns components.
+      const size_t archetypes = archetypes_.size();
+      for (size_t a = 0; a < archetypes; ++a) {
+        Archetype &archetype = *archetypes_[a];
+        if ((archetype.mask() & mask) != mask) continue;
+        for (size_t chunk = 0; chunk < archetype.chunks(); ++chunk)
+          each_in_chunk_<Components...>(archetype, chunk, f, std::index_sequence_for<Components...>());
+      }
+      return;
+    }
+    if (storage_ == ComponentStorage::SPARSE_SETS) {
+      SparseSet *sets[] = {sparse_set_<Components>()...};
+      SparseSet *lead = smallest_sparse_set_(sets, sizeof...(Components));
+      if (!lead) return;
+      for (size_t chunk = 0; chunk < lead->chunks(); ++chunk)
+        each_in_sparse_chunk_<Components...>(sets, lead, chunk, f, std::index_sequence_for<Components...>());
+      return;
+    }
+    BasePool *pools[] = {component_pool_<Components>()...};
+    for (BasePool *pool : pools) {
+      if (!pool) return;
+    }
+    each_in_range_<Components...>(mask, pools, 0, capacity(), f, std::index_sequence_for<Components...>());
+  }
+
+  template <typename ... Components, typename F, size_t ... I>
+  void each_in_range_(const ComponentMask &mask, BasePool *const *pools, size_t begin, size_t end, F &f,
+                      std::index_sequence<I ...>) {
+    for (size_t i = begin; i < end; ++i) {
+      if ((entity_component_mask_[i] & mask) != mask) continue;
+      Entity entity(this, Entity::Id(uint32_t(i), entity_version_[i]));
+      f(entity, *static_cast<Components*>(pools[I]->get(i))...);
+    }
+  }
+
+  // Calls f for every row of one chunk of an archetype that has all of Components.
+  template <typename ... Components, typename F, size_t ... I>
+  void each_in_chunk_(Archetype &archetype, size_t chunk, F &f, std::index_sequence<I ...>) {
+    void *columns[] = {archetype.chunk(archetype.column(component_family<Components>()), chunk)...};
+    const size_t first = chunk * archetype.chunk_rows();
+    const size_t rows = archetype.chunk_size(chunk);
+    for (size_t row = 0; row < rows; ++row) {
+      const uint32_t index = archetype.entity(first + row);
+      Entity entity(this, Entity::Id(index, entity_version_[index]));
+      f(entity, static_cast<Components*>(columns[I])[row]...);
+    }
+  }
+
+  template <typename ... Components, typename F>
+  void parallel_each_archetypes_(F &f, size_t grain_size) {
+    // Runs of whole chunks of a single archetype.
+    struct Task {
+      Archetype *archetype;
+      size_t begin, end;
+    };
+    const ComponentMask mask = component_mask<Components ...>();
+    std::vector<Task> tasks;
+    for (auto &archetype : archetypes_) {
+      if ((archetype->mask() & mask) != mask) continue;
+      const size_t chunks = archetype->chunks();
+      const size_t grain = std::max<size_t>(1, (grain_size + archetype->chunk_rows() - 1) / archetype->chunk_rows());
+      for (size_t chunk = 0; chunk < chunks; chunk += grain)
+        tasks.push_back(Task{archetype.get(), chunk, std::min(chunks, chunk + grain)});
+    }
+    auto run_task = [&](size_t task) {
+      for (size_t chunk = tasks[task].begin; chunk < tasks[task].end; ++chunk)
+        each_in_chunk_<Components...>(*tasks[task].archetype, chunk, f, std::index_sequence_for<Components...>());
+    };
+
+    if (!thread_pool_ || tasks.size() < 2) {
+      for (size_t task = 0; task < tasks.size(); ++task) run_task(task);
+    } else {
+      thread_pool_->parallel_for(tasks.size(), run_task);
+    }
+  }
+
+  // Calls f for every entity in one chunk of lead that has all of Components. lead is one of sets.
+  template <typename ... Components, typename F, size_t ... I>
+  void each_in_sparse_chunk_(SparseSet *const *sets, SparseSet *lead, size_t chunk, F &f,
+                             std::index_sequence<I ...>) {
+    void *lead_chunk = lead->chunk(chunk);
+    const size_t first = chunk * lead->chunk_rows();
+    const size_t rows = lead->chunk_size(chunk);
+    for (size_t row = 0; row < rows; ++row) {
+      const uint32_t index = lead->entity(first + row);
+      // Probe the other sets directly, as their lookups are needed anyway.
+      void *components[] = {sets[I] == lead ? static_cast<void*>(static_cast<Components*>(lead_chunk) + row)
+                                            : sets[I]->find(index)...};
+      if (std::find(std::begin(components), std::end(components), nullptr) != std::end(components)) continue;
+      Entity entity(this, Entity::Id(index, entity_version_[index]));
+      f(entity, *static_cast<Components*>(components[I])...);
+    }
+  }
+
+  template <typename ... Components, typename F>
+  void parallel_each_sparse_sets_(F &f, size_t grain_size) {
+    SparseSet *sets[] = {sparse_set_<Components>()...};
+    SparseSet *lead = smallest_sparse_set_(sets, sizeof...(Components));
+    if (!lead) return;
+    const size_t grain = std::max<size_t>(1, (grain_size + lead->chunk_rows() - 1) / lead->chunk_rows());
+    const size_t chunks = lead->chunks();
+    const size_t tasks = (chunks + grain - 1) / grain;
+    auto run_task = [&](size_t task) {
+      for (size_t chunk = task * grain; chunk < std::min(chunks, (task + 1) * grain); ++chunk)
+        each_in_sparse_chunk_<Components...>(sets, lead, chunk, f, std::index_sequence_for<Components...>());
+    };
+
+    if (!thread_pool_ || tasks < 2) {
+      for (size_t task = 0; task < tasks; ++task) run_task(task);
+    } else {
+      thread_pool_->parallel_for(tasks, run_task);
+    }
+  }
+
+  // The smallest of count sets, or nullptr if any of them does not exist yet.
+  static SparseSet *smallest_sparse_set_(SparseSet *const *sets, size_t count) {
+    SparseSet *smallest = nullptr;
+    for (size_t i = 0; i < count; ++i) {
+      if (!sets[i]) return nullptr;
+      if (!smallest || sets[i]->size() < smallest->size()) smallest = sets[i];
+    }
+    return smallest;
+  }
+
+  // The sparse set of component C, or nullptr if no C has been assigned yet.
+  template <typename C>
+  SparseSet *sparse_set_() const {
+    BaseComponent::Family family = component_family<C>();
+    return family < sparse_sets_.size() ? sparse_sets_[family].get() : nullptr;
+  }
+
+  // The pool of component C, or nullptr if no C has been assigned yet.
+  template <typename C>
+  BasePool *component_pool_() const {
+    BaseComponent::Family family = component_family<C>();
+    return family < component_pools_.size() ? component_pools_[family] : nullptr;
+  }
+
+
+  // Where an entity's components live with ComponentStorage::ARCHETYPES.
+  struct EntityLocation {
+    uint32_t archetype;
+    uint32_t row;
+  };
 
   uint32_t index_counter_ = 0;
+  help::ThreadPool *thread_pool_ = nullptr;
+  ComponentStorage storage_;
 
   EventManager &event_manager_;
   // Each element in component_pools_ corresponds to a Pool for a Component.
@@ -876,6 +1399,23 @@ class EntityManager : entityx::help::NonCopyable {
   std::vector<uint32_t> entity_version_;
   // List of available entity slots.
   std::vector<uint32_t> free_list_;
+
+  // ComponentStorage::ARCHETYPES only. Archetypes are never destroyed before reset(), so their
+  // indices are stable.
+  std::vector<std::unique_ptr<Archetype>> archetypes_;
+  std::unordered_map<ComponentMask, uint32_t> archetype_index_;
+  // How to move and destroy each component family, indexed by family.
+  std::vector<const ComponentOps*> component_ops_;
+  // The archetype and row of each entity. Index into the vector is the Entity::Id.
+  std::vector<EntityLocation> entity_location_;
+
+  // The lists behind cached_view(), by component mask. CachedViews point into them, so they live
+  // as long as the EntityManager.
+  std::vector<std::unique_ptr<Membership>> memberships_;
+  std::unordered_map<ComponentMask, Membership*> membership_index_;
+
+  // ComponentStorage::SPARSE_SETS only. The set for each component, indexed by family.
+  std::vector<std::unique_ptr<SparseSet>> sparse_sets_;
 };
 
 
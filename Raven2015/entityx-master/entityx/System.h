@@ -11,14 +11,19 @@
 #pragma once
 
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 #include <cassert>
 #include "entityx/config.h"
 #include "entityx/Entity.h"
 #include "entityx/Event.h"
 #include "entityx/help/NonCopyable.h"
+#include "entityx/help/ThreadPool.h"
 
 
 namespace entityx {
@@ -27,6 +32,64 @@ namespace entityx {
 class SystemManager;
 
 
+/**
+ * The components a System reads and writes in update(), as declared by BaseSystem::access().
+ *
+ * Two Systems conflict if either writes a component the other reads or writes, or if either is
+ * exclusive. SystemScheduler never runs conflicting Systems at the same time.
+ *
+ *   access.reads<Direction>().writes<Position>();
+ */
+class ComponentAccess {
+ public:
+  typedef EntityManager::ComponentMask ComponentMask;
+
+  ComponentAccess() : exclusive_(false) {}
+
+  template <typename ... Components>
+  ComponentAccess &reads() {
+    reads_ |= mask<Components ...>();
+    return *this;
+  }
+
+  template <typename ... Components>
+  ComponentAccess &writes() {
+    writes_ |= mask<Components ...>();
+    return *this;
+  }
+
+  /// Declare state beyond components (creating entities, a window, ...) that no other System may touch meanwhile.
+  ComponentAccess &exclusive() {
+    exclusive_ = true;
+    return *this;
+  }
+
+  bool conflicts_with(const ComponentAccess &other) const {
+    return exclusive_ || other.exclusive_ ||
+        (writes_ & (other.reads_ | other.writes_)).any() ||
+        (other.writes_ & reads_).any();
+  }
+
+  void reset() {
+    reads_.reset();
+    writes_.reset();
+    exclusive_ = false;
+  }
+
+ private:
+  template <typename ... Components>
+  static ComponentMask mask() {
+    ComponentMask mask;
+    int expand[] = {0, (mask.set(Component<typename std::remove_const<Components>::type>::family()), 0) ...};
+    (void)expand;
+    return mask;
+  }
+
+  ComponentMask reads_, writes_;
+  bool exclusive_;
+};
+
+
 /**
  * Base System class. Generally should not be directly used, instead see System<Derived>.
  */
@@ -57,6 +120,15 @@ class BaseSystem : entityx::help::NonCopyable {
    */
   virtual void update(EntityManager &entities, EventManager &events, TimeDelta dt) = 0;
 
+  /**
+   * Declare the components update() reads and writes, for SystemScheduler.
+   *
+   * Systems that do not override this are exclusive and never run alongside another System.
+   */
+  virtual void access(ComponentAccess &access) const {
+    access.exclusive();
+  }
+
   static Family family_counter_;
 
  protected:
@@ -176,4 +248,70 @@ class SystemManager : entityx::help::NonCopyable {
   std::unordered_map<BaseSystem::Family, std::shared_ptr<BaseSystem>> systems_;
 };
 
+
+/**
+ * Updates a sequence of Systems once per tick, running Systems that do not conflict (see
+ * ComponentAccess) concurrently on a ThreadPool.
+ *
+ * The dependency graph is rebuilt from each System's access() on every update(): a System waits
+ * for every earlier System in the sequence that it conflicts with, so the outcome matches running
+ * the sequence in order. In serial mode, or without a pool, that is exactly what happens, on the
+ * calling thread, which makes for deterministic debugging.
+ *
+ * Concurrent Systems must not create or destroy entities or assign or remove components; they can
+ * record those changes in a CommandBuffer, played after update() returns. Likewise they should
+ * post() events rather than emit them; posted events are merged in sequence order, so the order
+ * they are dispatched in does not depend on scheduling.
+ *
+ *   SystemScheduler scheduler(entities, events, &pool);
+ *   scheduler.add(systems.system<InputSystem>());
+ *   scheduler.add(systems.system<MovementSystem>());
+ *   scheduler.update(dt);
+ */
+class SystemScheduler : entityx::help::NonCopyable {
+ public:
+  SystemScheduler(EntityManager &entity_manager, EventManager &event_manager,
+                  help::ThreadPool *pool = nullptr) :
+                  entity_manager_(entity_manager),
+                  event_manager_(event_manager),
+                  pool_(pool) {}
+
+  /**
+   * Append a System to the sequence.
+   */
+  void add(std::shared_ptr<BaseSystem> system);
+
+  void set_pool(help::ThreadPool *pool) { pool_ = pool; }
+
+  /**
+   * Run every System in sequence on the calling thread instead.
+   */
+  void set_serial(bool serial) { serial_ = serial; }
+  bool serial() const { return serial_; }
+
+  /**
+   * Update every System in the sequence once, returning when all have finished.
+   */
+  void update(TimeDelta dt);
+
+  /**
+   * For each System in the sequence, the earlier Systems it waited for during the last update().
+   */
+  const std::vector<std::vector<size_t>> &dependencies() const { return dependencies_; }
+
+ private:
+  void run(size_t index, TimeDelta dt);
+  void update_system(size_t index, TimeDelta dt);
+
+  EntityManager &entity_manager_;
+  EventManager &event_manager_;
+  help::ThreadPool *pool_;
+  bool serial_ = false;
+  std::vector<std::shared_ptr<BaseSystem>> systems_;
+  std::vector<ComponentAccess> access_;
+  std::vector<std::vector<size_t>> dependencies_;
+  std::vector<std::vector<size_t>> dependents_;
+  std::unique_ptr<std::atomic<size_t>[]> remaining_;
+};
+
 }  // namespace entityx
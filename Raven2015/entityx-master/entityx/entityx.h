@@ -5,3 +5,4 @@
 #include "entityx/Entity.h"
 #include "entityx/System.h"
 #include "entityx/quick.h"
+#include "entityx/CommandBuffer.h"
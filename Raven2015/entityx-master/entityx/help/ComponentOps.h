@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace entityx {
+
+/**
+ * Type-erased operations on a component type, so that storage such as
+ * Archetype and SparseSet can move and destroy components without knowing
+ * their types.
+ */
+struct ComponentOps {
+  std::size_t size;
+  /// Move-construct a component into uninitialised memory at to, then destroy the one at from.
+  void (*relocate)(void *to, void *from);
+  void (*destroy)(void *ptr);
+};
+
+template <typename C>
+const ComponentOps *component_ops() {
+  static const ComponentOps ops = {
+    sizeof(C),
+    [](void *to, void *from) {
+      C *source = static_cast<C*>(from);
+      ::new(to) C(std::move(*source));
+      source->~C();
+    },
+    [](void *ptr) { static_cast<C*>(ptr)->~C(); }
+  };
+  return &ops;
+}
+
+}  // namespace entityx
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "entityx/help/NonCopyable.h"
+
+namespace entityx {
+namespace help {
+
+/**
+ * A fixed set of worker threads consuming a shared task queue.
+ *
+ * wait() blocks until every queued task has finished, and the waiting thread
+ * executes queued tasks itself in the meantime. A pool with zero workers
+ * therefore runs everything inline.
+ */
+class ThreadPool : NonCopyable {
+ public:
+  explicit ThreadPool(std::size_t workers = default_workers());
+  ~ThreadPool();
+
+  /// Number of worker threads (not counting the thread calling wait()).
+  std::size_t size() const { return workers_.size(); }
+
+  /// Queue a task for execution.
+  void submit(std::function<void()> task);
+
+  /// Block until every queued task has completed.
+  void wait();
+
+  /**
+   * Call f(i) for every i in [0, count), spread across the workers and the
+   * calling thread. Returns once every call has completed, without waiting for
+   * unrelated tasks, so it may also be called from within a task.
+   */
+  void parallel_for(std::size_t count, const std::function<void(std::size_t)> &f);
+
+  /// One less than the number of hardware threads, leaving a core for the caller.
+  static std::size_t default_workers();
+
+ private:
+  void run();
+  bool run_one(std::unique_lock<std::mutex> &lock);
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable work_done_;
+  std::size_t pending_ = 0;
+  bool stopping_ = false;
+};
+
+}  // namespace help
+}  // namespace entityx
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <atomic>
+#include <vector>
+#include "entityx/3rdparty/catch.hpp"
+#include "entityx/help/ThreadPool.h"
+
+using namespace entityx::help;
+
+TEST_CASE("TestThreadPoolRunsEveryTask") {
+  ThreadPool pool(4);
+  REQUIRE(4 == pool.size());
+  std::atomic<int> counter(0);
+  for (int i = 0; i < 1000; ++i) {
+    pool.submit([&counter] { ++counter; });
+  }
+  pool.wait();
+  REQUIRE(1000 == counter.load());
+}
+
+TEST_CASE("TestThreadPoolParallelForVisitsEachIndexOnce") {
+  ThreadPool pool(3);
+  std::vector<int> visits(257, 0);
+  pool.parallel_for(visits.size(), [&visits](std::size_t i) { visits[i]++; });
+  for (int v : visits) {
+    REQUIRE(1 == v);
+  }
+}
+
+TEST_CASE("TestThreadPoolWithoutWorkersRunsInline") {
+  ThreadPool pool(0);
+  REQUIRE(0 == pool.size());
+  std::thread::id caller = std::this_thread::get_id();
+  bool inline_ = true;
+  pool.parallel_for(10, [&](std::size_t) { inline_ = inline_ && std::this_thread::get_id() == caller; });
+  REQUIRE(inline_);
+}
+
+TEST_CASE("TestThreadPoolIsReusable") {
+  ThreadPool pool(2);
+  std::atomic<int> counter(0);
+  for (int round = 0; round < 50; ++round) {
+    pool.parallel_for(8, [&counter](std::size_t) { ++counter; });
+    int expected = (round + 1) * 8;
+    REQUIRE(expected == counter.load());
+  }
+}
@@ -23,7 +23,8 @@ namespace entityx {
  */
 class EntityX {
  public:
-  EntityX() : entities(events), systems(entities, events) {}
+  explicit EntityX(ComponentStorage storage = ComponentStorage::POOLS)
+      : entities(events, storage), systems(entities, events) {}
 
   EventManager events;
   EntityManager entities;
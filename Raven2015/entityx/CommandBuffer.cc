@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2012 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "entityx/CommandBuffer.h"
+
+namespace entityx {
+
+// One thread's commands. Only its owning thread records into it, so it needs no locking.
+struct CommandBuffer::Arena {
+  static const std::size_t BLOCK_SIZE = 16384;
+
+  explicit Arena(std::thread::id owner) : owner(owner) {}
+
+  ~Arena() {
+    clear();
+    for (char *block : blocks) delete[] block;
+  }
+
+  void clear() {
+    for (Command *command : commands) command->~Command();
+    commands.clear();
+    for (char *allocation : large) delete[] allocation;
+    large.clear();
+    block = 0;
+    used = 0;
+    created.clear();
+    pending = 0;
+  }
+
+  std::thread::id owner;
+  Arena *next = nullptr;
+  // Commands are packed into fixed-size blocks, which are kept for reuse after clear().
+  std::vector<char *> blocks;
+  std::size_t block = 0;
+  std::size_t used = 0;
+  // Commands too big for a block get an allocation of their own.
+  std::vector<char *> large;
+  std::vector<Command *> commands;
+  // Number of create() calls, and the entities made for them once the buffer is played.
+  std::uint32_t pending = 0;
+  std::vector<Entity::Id> created;
+};
+
+const std::size_t CommandBuffer::Arena::BLOCK_SIZE;
+
+namespace {
+
+std::atomic<std::uint64_t> next_buffer_id(1);
+
+// Each thread remembers its arenas in the last few buffers it recorded into.
+struct CachedArena {
+  std::uint64_t buffer;
+  void *arena;
+};
+const std::size_t ARENA_CACHE_SIZE = 4;
+thread_local CachedArena arena_cache[ARENA_CACHE_SIZE] = {};
+thread_local std::size_t arena_cache_next = 0;
+
+}  // namespace
+
+CommandBuffer::CommandBuffer() : id_(next_buffer_id++), arenas_(nullptr) {
+}
+
+CommandBuffer::~CommandBuffer() {
+  Arena *arena = arenas_.load(std::memory_order_acquire);
+  while (arena) {
+    Arena *next = arena->next;
+    delete arena;
+    arena = next;
+  }
+}
+
+CommandBuffer::PendingEntity CommandBuffer::create() {
+  Arena &arena = arena_();
+  return PendingEntity(&arena, arena.pending++);
+}
+
+void CommandBuffer::destroy(Entity::Id id) {
+  record_<DestroyCommand>(Target(id));
+}
+
+std::size_t CommandBuffer::size() const {
+  std::size_t count = 0;
+  for (Arena *arena = arenas_.load(std::memory_order_acquire); arena; arena = arena->next) {
+    count += arena->commands.size() + arena->pending;
+  }
+  return count;
+}
+
+void CommandBuffer::play(EntityManager &entities) {
+  Arena *head = arenas_.load(std::memory_order_acquire);
+  // Create every recorded entity first, so commands may target entities created on other threads.
+  for (Arena *arena = head; arena; arena = arena->next) {
+    for (std::uint32_t i = 0; i < arena->pending; ++i) {
+      arena->created.push_back(entities.create().id());
+    }
+  }
+  for (Arena *arena = head; arena; arena = arena->next) {
+    for (Command *command : arena->commands) {
+      const Entity::Id id = command->target.resolve();
+      if (entities.valid(id)) command->play(entities, id);
+    }
+  }
+  clear();
+}
+
+void CommandBuffer::clear() {
+  for (Arena *arena = arenas_.load(std::memory_order_acquire); arena; arena = arena->next) {
+    arena->clear();
+  }
+}
+
+Entity::Id CommandBuffer::Target::resolve() const {
+  return arena ? arena->created[slot] : id;
+}
+
+CommandBuffer::Arena &CommandBuffer::arena_() {
+  for (const CachedArena &cached : arena_cache) {
+    if (cached.buffer == id_) return *static_cast<Arena*>(cached.arena);
+  }
+
+  // This thread's first command since its cache entry was evicted: find its arena, or publish a
+  // new one at the head of the list.
+  const std::thread::id self = std::this_thread::get_id();
+  Arena *arena = arenas_.load(std::memory_order_acquire);
+  while (arena && arena->owner != self) arena = arena->next;
+  if (!arena) {
+    arena = new Arena(self);
+    arena->next = arenas_.load(std::memory_order_relaxed);
+    while (!arenas_.compare_exchange_weak(arena->next, arena, std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+  }
+  arena_cache[arena_cache_next++ % ARENA_CACHE_SIZE] = CachedArena{id_, arena};
+  return *arena;
+}
+
+void *CommandBuffer::allocate_(Arena &arena, std::size_t size) {
+  const std::size_t align = alignof(std::max_align_t);
+  size = (size + align - 1) / align * align;
+  if (size > Arena::BLOCK_SIZE) {
+    arena.large.push_back(new char[size]);
+    return arena.large.back();
+  }
+  if (arena.blocks.empty() || arena.used + size > Arena::BLOCK_SIZE) {
+    if (!arena.blocks.empty()) ++arena.block;
+    if (arena.block == arena.blocks.size()) arena.blocks.push_back(new char[Arena::BLOCK_SIZE]);
+    arena.used = 0;
+  }
+  void *memory = arena.blocks[arena.block] + arena.used;
+  arena.used += size;
+  return memory;
+}
+
+void CommandBuffer::push_(Arena &arena, Command *command) {
+  arena.commands.push_back(command);
+}
+
+}  // namespace entityx
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2012 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "entityx/Entity.h"
+#include "entityx/help/NonCopyable.h"
+
+namespace entityx {
+
+/**
+ * Records structural changes to entities (create, destroy, assign and remove) so that they can
+ * be applied later, at a point where nothing is iterating over the EntityManager.
+ *
+ * Commands may be recorded from any number of threads at once, for example from
+ * EntityManager::parallel_each() or from Systems run by a SystemScheduler. Each thread records
+ * into its own arena, so recording takes no locks.
+ *
+ * @code
+ * CommandBuffer commands;
+ * entities.each<Health>([&](Entity entity, Health &health) {
+ *   if (health.hp <= 0) commands.destroy(entity.id());
+ * });
+ * commands.play(entities);
+ * @endcode
+ */
+class CommandBuffer : entityx::help::NonCopyable {
+  struct Arena;
+
+ public:
+  /**
+   * An entity that create() has recorded. It exists once the buffer is played, and can be the
+   * target of assign() until then.
+   */
+  class PendingEntity {
+   private:
+    friend class CommandBuffer;
+
+    PendingEntity(const Arena *arena, std::uint32_t slot) : arena_(arena), slot_(slot) {}
+
+    const Arena *arena_;
+    std::uint32_t slot_;
+  };
+
+  CommandBuffer();
+  /// Discards any commands that have not been played.
+  ~CommandBuffer();
+
+  PendingEntity create();
+
+  void destroy(Entity::Id id);
+
+  /// Record assigning a C constructed from args now. If the entity already has a C when the
+  /// buffer is played, the recorded one replaces it.
+  template <typename C, typename ... Args>
+  void assign(Entity::Id id, Args && ... args) {
+    record_<AssignCommand<C>>(Target(id), std::forward<Args>(args) ...);
+  }
+
+  template <typename C, typename ... Args>
+  void assign(PendingEntity entity, Args && ... args) {
+    record_<AssignCommand<C>>(Target(entity), std::forward<Args>(args) ...);
+  }
+
+  template <typename C>
+  void remove(Entity::Id id) {
+    record_<RemoveCommand<C>>(Target(id));
+  }
+
+  /// Number of commands recorded, from all threads. Must not be called while recording.
+  std::size_t size() const;
+  bool empty() const { return size() == 0; }
+
+  /**
+   * Apply the recorded commands to entities, then clear the buffer.
+   *
+   * Recorded entities are created first. Then each thread's commands are applied in the order
+   * that thread recorded them; the order between threads is unspecified. Commands on entities
+   * that no longer exist, removals of missing components and repeated destroys are dropped.
+   *
+   * Must not be called while any thread is recording.
+   */
+  void play(EntityManager &entities);
+
+  /// Discard the recorded commands. Must not be called while any thread is recording.
+  void clear();
+
+ private:
+  // The entity a command applies to: an existing one, or one created by the buffer.
+  struct Target {
+    explicit Target(Entity::Id id) : id(id), arena(nullptr), slot(0) {}
+    explicit Target(PendingEntity entity) : arena(entity.arena_), slot(entity.slot_) {}
+
+    Entity::Id resolve() const;
+
+    Entity::Id id;
+    const Arena *arena;
+    std::uint32_t slot;
+  };
+
+  struct Command {
+    explicit Command(Target target) : target(target) {}
+    virtual ~Command() {}
+    virtual void play(EntityManager &entities, Entity::Id id) = 0;
+
+    Target target;
+  };
+
+  struct DestroyCommand : Command {
+    explicit DestroyCommand(Target target) : Command(target) {}
+    void play(EntityManager &entities, Entity::Id id) override { entities.destroy(id); }
+  };
+
+  template <typename C>
+  struct AssignCommand : Command {
+    template <typename ... Args>
+    explicit AssignCommand(Target target, Args && ... args)
+        : Command(target), component(std::forward<Args>(args) ...) {}
+
+    void play(EntityManager &entities, Entity::Id id) override {
+      if (entities.has_component<C>(id)) {
+        *entities.component<C>(id).get() = std::move(component);
+      } else {
+        entities.assign<C>(id, std::move(component));
+      }
+    }
+
+    C component;
+  };
+
+  template <typename C>
+  struct RemoveCommand : Command {
+    explicit RemoveCommand(Target target) : Command(target) {}
+    void play(EntityManager &entities, Entity::Id id) override {
+      if (entities.has_component<C>(id)) entities.remove<C>(id);
+    }
+  };
+
+  template <typename T, typename ... Args>
+  void record_(Args && ... args) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned components cannot be recorded");
+    Arena &arena = arena_();
+    push_(arena, ::new(allocate_(arena, sizeof(T))) T(std::forward<Args>(args) ...));
+  }
+
+  // The calling thread's arena, creating it on the thread's first use of this buffer.
+  Arena &arena_();
+
+  // Reserve memory for a command in an arena.
+  static void *allocate_(Arena &arena, std::size_t size);
+  // Append a constructed command to an arena's command list.
+  static void push_(Arena &arena, Command *command);
+
+  // Identifies this buffer in each thread's cache of arenas, as addresses may be reused.
+  const std::uint64_t id_;
+  // One arena per thread that has recorded, pushed with compare-and-swap.
+  std::atomic<Arena*> arenas_;
+};
+
+}  // namespace entityx
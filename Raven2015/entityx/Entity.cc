@@ -14,6 +14,7 @@
 namespace entityx {
 
 const Entity::Id Entity::INVALID;
+const uint32_t EntityManager::Membership::ABSENT;
 BaseComponent::Family BaseComponent::family_counter_ = 0;
 
 void Entity::invalidate() {
@@ -31,7 +32,8 @@ std::bitset<entityx::MAX_COMPONENTS> Entity::component_mask() const {
   return manager_->component_mask(id_);
 }
 
-EntityManager::EntityManager(EventManager &event_manager) : event_manager_(event_manager) {
+EntityManager::EntityManager(EventManager &event_manager, ComponentStorage storage)
+    : storage_(storage), event_manager_(event_manager), component_ops_(entityx::MAX_COMPONENTS, nullptr) {
 }
 
 EntityManager::~EntityManager() {
@@ -44,12 +46,97 @@ void EntityManager::reset() {
     if (pool) delete pool;
   }
   component_pools_.clear();
+  archetypes_.clear();
+  archetype_index_.clear();
+  entity_location_.clear();
+  sparse_sets_.clear();
+  // CachedViews may outlive a reset(), so keep the lists themselves.
+  for (auto &membership : memberships_) {
+    membership->entities.clear();
+    membership->positions.clear();
+  }
   entity_component_mask_.clear();
   entity_version_.clear();
   free_list_.clear();
   index_counter_ = 0;
 }
 
+EntityManager::Membership *EntityManager::membership_for_(const ComponentMask &mask) {
+  auto it = membership_index_.find(mask);
+  if (it != membership_index_.end()) return it->second;
+  Membership *membership = new Membership(mask);
+  memberships_.emplace_back(membership);
+  membership_index_.emplace(mask, membership);
+  for (uint32_t index = 0; index < entity_component_mask_.size(); ++index) {
+    if ((entity_component_mask_[index] & mask) == mask) membership->insert(index);
+  }
+  return membership;
+}
+
+void EntityManager::update_memberships_(uint32_t index, const ComponentMask &before, const ComponentMask &after) {
+  for (auto &membership : memberships_) {
+    const bool was = (before & membership->mask) == membership->mask;
+    const bool is = (after & membership->mask) == membership->mask;
+    if (was == is) continue;
+    if (is) {
+      membership->insert(index);
+    } else {
+      membership->erase(index);
+    }
+  }
+}
+
+std::vector<ComponentMemoryUsage> EntityManager::memory_usage() const {
+  std::vector<ComponentMemoryUsage> usage;
+  for (size_t family = 0; family < MAX_COMPONENTS; ++family) {
+    ComponentMemoryUsage component = {family, 0, 0, 0};
+    if (storage_ == ComponentStorage::ARCHETYPES) {
+      if (!component_ops_[family]) continue;
+      for (const auto &archetype : archetypes_) {
+        if (!archetype->mask().test(family)) continue;
+        component.count += archetype->size();
+        component.capacity += archetype->capacity();
+        component.bytes += archetype->capacity() * component_ops_[family]->size;
+      }
+    } else if (storage_ == ComponentStorage::SPARSE_SETS) {
+      if (family >= sparse_sets_.size() || !sparse_sets_[family]) continue;
+      const SparseSet &set = *sparse_sets_[family];
+      component.count = set.size();
+      component.capacity = set.capacity();
+      component.bytes = set.memory();
+    } else {
+      if (family >= component_pools_.size() || !component_pools_[family]) continue;
+      const BasePool &pool = *component_pools_[family];
+      for (const ComponentMask &mask : entity_component_mask_) {
+        if (mask.test(family)) ++component.count;
+      }
+      component.capacity = pool.capacity();
+      component.bytes = pool.memory();
+    }
+    usage.push_back(component);
+  }
+  return usage;
+}
+
+uint32_t EntityManager::archetype_for_(const ComponentMask &mask) {
+  auto it = archetype_index_.find(mask);
+  if (it != archetype_index_.end()) return it->second;
+  const uint32_t archetype = uint32_t(archetypes_.size());
+  archetypes_.emplace_back(new Archetype(mask, component_ops_));
+  archetype_index_.emplace(mask, archetype);
+  return archetype;
+}
+
+void EntityManager::move_entity_(uint32_t index, const ComponentMask &mask) {
+  // Look up the destination first, as creating it may reallocate archetypes_.
+  const uint32_t to = archetype_for_(mask);
+  EntityLocation &location = entity_location_[index];
+  Archetype &from = *archetypes_[location.archetype];
+  const uint32_t row = uint32_t(from.migrate(location.row, *archetypes_[to]));
+  entity_location_[from.erase(location.row)].row = location.row;
+  location = EntityLocation{to, row};
+}
+
 EntityCreatedEvent::~EntityCreatedEvent() {}
 EntityDestroyedEvent::~EntityDestroyedEvent() {}
 
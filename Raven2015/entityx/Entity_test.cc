@@ -11,6 +11,7 @@
 #define CATCH_CONFIG_MAIN
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <string>
 #include <utility>
@@ -628,3 +629,359 @@ TEST_CASE_METHOD(EntityManagerFixture, "TestViewEach") {
   });
   REQUIRE(count == 1);
 }
+
+TEST_CASE_METHOD(EntityManagerFixture, "TestEntityManagerParallelEach") {
+  help::ThreadPool pool(3);
+  vector<Entity> moving, still;
+  for (int i = 0; i < 20000; ++i) {
+    Entity e = em.create();
+    e.assign<Position>(float(i), 0.0f);
+    if (i % 3 != 0) {
+      still.push_back(e);
+    } else {
+      e.assign<Direction>(1.0f, 2.0f);
+      moving.push_back(e);
+    }
+  }
+  // A freed slot keeps no components and must be skipped
+  moving.back().destroy();
+  moving.pop_back();
+
+  std::atomic<int> count(0);
+  auto move = [&count](Entity entity, Position &position, Direction &direction) {
+    position.x += direction.x;
+    position.y += direction.y;
+    ++count;
+  };
+
+  // Serially without a pool, then on the pool with the default and a coarser grain
+  em.parallel_each<Position, Direction>(move);
+  em.set_thread_pool(&pool);
+  em.parallel_each<Position, Direction>(move);
+  em.parallel_each<Position, Direction>(move, 10000);
+
+  int expected = int(moving.size()) * 3;
+  REQUIRE(expected == count.load());
+  for (Entity e : moving) {
+    REQUIRE(e.component<Position>()->y == 6.0f);
+  }
+  for (Entity e : still) {
+    REQUIRE(e.component<Position>()->y == 0.0f);
+  }
+}
+
+TEST_CASE_METHOD(EntityManagerFixture, "TestParallelEachWithUnassignedComponent") {
+  em.create().assign<Position>();
+  int count = 0;
+  em.parallel_each<Position, Direction>([&count](Entity, Position &, Direction &) { ++count; });
+  REQUIRE(0 == count);
+}
+
+TEST_CASE_METHOD(EntityManagerFixture, "TestEachWithCallableMatchesStdFunction") {
+  for (int i = 0; i < 100; ++i) {
+    Entity e = em.create();
+    e.assign<Position>(float(i), 0.0f);
+    if (i % 4 == 0) e.assign<Direction>(1.0f, 1.0f);
+    if (i % 8 == 0) e.destroy();
+  }
+
+  float erased_sum = 0.0f, inlined_sum = 0.0f, view_sum = 0.0f;
+  std::function<void(Entity, Position &, Direction &)> erased = [&](Entity, Position &p, Direction &) {
+    erased_sum += p.x;
+  };
+  em.each<Position, Direction>(erased);
+  em.each<Position, Direction>([&](Entity &entity, Position &p, Direction &) {
+    REQUIRE(entity.valid());
+    inlined_sum += p.x;
+  });
+  em.entities_with_components<Position, Direction>().each([&](Entity, Position &p, Direction &) {
+    view_sum += p.x;
+  });
+
+  REQUIRE(erased_sum > 0.0f);
+  REQUIRE(erased_sum == inlined_sum);
+  REQUIRE(erased_sum == view_sum);
+}
+
+struct ArchetypeFixture {
+  ArchetypeFixture() : em(ev, ComponentStorage::ARCHETYPES) {}
+
+  EventManager ev;
+  EntityManager em;
+};
+
+TEST_CASE_METHOD(ArchetypeFixture, "TestArchetypeStorageHandlesSurviveMoves") {
+  Entity a = em.create(), b = em.create(), c = em.create();
+  ComponentHandle<Position> pa = a.assign<Position>(1, 1);
+  ComponentHandle<Position> pb = b.assign<Position>(2, 2);
+  ComponentHandle<Position> pc = c.assign<Position>(3, 3);
+
+  // b moves to the (Position, Direction) archetype and c fills its old row
+  b.assign<Direction>(4, 4);
+  REQUIRE(*pa.get() == Position(1, 1));
+  REQUIRE(*pb.get() == Position(2, 2));
+  REQUIRE(*pc.get() == Position(3, 3));
+  REQUIRE(*b.component<Direction>().get() == Direction(4, 4));
+
+  a.destroy();
+  REQUIRE(!pa.valid());
+  REQUIRE(*pc.get() == Position(3, 3));
+
+  b.remove<Position>();
+  REQUIRE(!b.has_component<Position>());
+  REQUIRE(*b.component<Direction>().get() == Direction(4, 4));
+
+  Entity d = em.create();
+  REQUIRE(!d.has_component<Position>());
+  REQUIRE(size(em.entities_with_components<Position>()) == 1);
+  REQUIRE(size(em.entities_with_components<Direction>()) == 1);
+}
+
+TEST_CASE("TestArchetypeStorageDestroysEveryComponent") {
+  struct Counted : Component<Counted> {
+    explicit Counted(int &live) : live(&live) { ++*this->live; }
+    Counted(Counted &&other) : live(other.live) { ++*live; }
+    ~Counted() { --*live; }
+
+    int *live;
+  };
+
+  int live = 0;
+  {
+    EntityX ex(ComponentStorage::ARCHETYPES);
+    vector<Entity> entities;
+    for (int i = 0; i < 1000; ++i) {
+      Entity e = ex.entities.create();
+      e.assign<Counted>(live);
+      if (i % 2) e.assign<Position>();
+      entities.push_back(e);
+    }
+    REQUIRE(live == 1000);
+    for (int i = 0; i < 1000; i += 3) entities[i].remove<Counted>();
+    for (int i = 1; i < 1000; i += 3) entities[i].destroy();
+    REQUIRE(live == 333);
+  }
+  REQUIRE(live == 0);
+}
+
+TEST_CASE("TestArchetypeStorageEachMatchesPools") {
+  EntityX pools, archetypes(ComponentStorage::ARCHETYPES);
+  for (EntityX *ex : {&pools, &archetypes}) {
+    for (int i = 0; i < 5000; ++i) {
+      Entity e = ex->entities.create();
+      e.assign<Position>(float(i), 0.0f);
+      if (i % 3 == 0) e.assign<Direction>(1.0f, 1.0f);
+      if (i % 5 == 0) e.assign<Tag>("tag");
+      if (i % 7 == 0) e.destroy();
+    }
+  }
+
+  help::ThreadPool pool(2);
+  archetypes.entities.set_thread_pool(&pool);
+  float sums[2][3] = {};
+  int n = 0;
+  for (EntityX *ex : {&pools, &archetypes}) {
+    ex->entities.each<Position, Direction>([&](Entity entity, Position &p, Direction &) {
+      sums[n][0] += p.x;
+    });
+    for (Entity entity : ex->entities.entities_with_components<Position, Direction>()) {
+      sums[n][1] += entity.component<Position>()->x;
+    }
+    std::atomic<int> count(0);
+    ex->entities.parallel_each<Position, Direction>([&](Entity, Position &p, Direction &) { ++count; }, 300);
+    sums[n][2] = float(count.load());
+    ++n;
+  }
+
+  REQUIRE(sums[0][0] > 0.0f);
+  REQUIRE(sums[0][0] == sums[1][0]);
+  REQUIRE(sums[0][1] == sums[1][1]);
+  REQUIRE(sums[0][0] == sums[1][1]);
+  REQUIRE(sums[0][2] == sums[1][2]);
+}
+
+TEST_CASE("TestSparseSetStorageHandlesSurviveRemoval") {
+  EntityX ex(ComponentStorage::SPARSE_SETS);
+  Entity a = ex.entities.create(), b = ex.entities.create(), c = ex.entities.create();
+  ComponentHandle<Position> pa = a.assign<Position>(1, 1);
+  ComponentHandle<Position> pc = c.assign<Position>(3, 3);
+  b.assign<Direction>(2, 2);
+
+  // c's Position moves into a's packed slot
+  a.remove<Position>();
+  REQUIRE(!pa.valid());
+  REQUIRE(*pc.get() == Position(3, 3));
+  a.assign<Position>(4, 4);
+  REQUIRE(*a.component<Position>().get() == Position(4, 4));
+
+  c.destroy();
+  REQUIRE(*a.component<Position>().get() == Position(4, 4));
+  REQUIRE(*b.component<Direction>().get() == Direction(2, 2));
+  REQUIRE(!ex.entities.create().has_component<Position>());
+  REQUIRE(size(ex.entities.entities_with_components<Position>()) == 1);
+}
+
+TEST_CASE("TestSparseSetStorageEachMatchesPools") {
+  struct Counted : Component<Counted> {
+    explicit Counted(int &live) : live(&live) { ++*this->live; }
+    Counted(Counted &&other) : live(other.live) { ++*live; }
+    ~Counted() { --*live; }
+
+    int *live;
+  };
+
+  int live = 0;
+  {
+    EntityX pools, sparse(ComponentStorage::SPARSE_SETS);
+    for (EntityX *ex : {&pools, &sparse}) {
+      for (int i = 0; i < 5000; ++i) {
+        Entity e = ex->entities.create();
+        e.assign<Counted>(live);
+        e.assign<Position>(float(i), 0.0f);
+        if (i % 3 == 0) e.assign<Direction>(1.0f, 1.0f);
+        if (i % 5 == 0) e.remove<Counted>();
+        if (i % 7 == 0) e.destroy();
+      }
+    }
+
+    help::ThreadPool pool(2);
+    sparse.entities.set_thread_pool(&pool);
+    float sums[2][3] = {};
+    int n = 0;
+    for (EntityX *ex : {&pools, &sparse}) {
+      ex->entities.each<Direction, Position>([&](Entity entity, Direction &, Position &p) {
+        sums[n][0] += p.x;
+      });
+      ex->entities.each<Counted>([&](Entity entity, Counted &) { sums[n][1] += 1.0f; });
+      std::atomic<int> count(0);
+      ex->entities.parallel_each<Position, Direction>([&](Entity, Position &p, Direction &) { ++count; }, 300);
+      sums[n][2] = float(count.load());
+      ++n;
+    }
+
+    REQUIRE(sums[0][0] > 0.0f);
+    REQUIRE(sums[0][0] == sums[1][0]);
+    REQUIRE(sums[0][1] == sums[1][1]);
+    REQUIRE(sums[0][2] == sums[1][2]);
+  }
+  REQUIRE(live == 0);
+}
+
+struct Rare : Component<Rare> {
+  char payload[200];
+};
+
+namespace entityx {
+template <> struct ComponentStorageTraits<Rare> { static const std::size_t chunk_size = 4; };
+}
+
+TEST_CASE("TestComponentStorageTraitsChunkSize") {
+  struct Large {
+    char payload[4000];
+  };
+  struct Medium {
+    char payload[100];
+  };
+
+  REQUIRE(8192 == ComponentStorageTraits<Position>::chunk_size);
+  REQUIRE(512 == ComponentStorageTraits<Medium>::chunk_size);
+  REQUIRE(64 == ComponentStorageTraits<Large>::chunk_size);
+  REQUIRE(4 == std::size_t(ComponentStorageTraits<Rare>::chunk_size));
+}
+
+TEST_CASE("TestReserveAndMemoryUsage") {
+  for (ComponentStorage storage : {ComponentStorage::POOLS, ComponentStorage::SPARSE_SETS,
+                                   ComponentStorage::ARCHETYPES}) {
+    EntityX ex(storage);
+    REQUIRE(ex.entities.memory_usage().empty());
+
+    ex.entities.reserve<Position>(10000);
+    Entity e = ex.entities.create();
+    e.assign<Position>();
+    e.assign<Rare>();
+    ex.entities.create().assign<Position>();
+
+    vector<ComponentMemoryUsage> usage = ex.entities.memory_usage();
+    REQUIRE(2 == usage.size());
+    const ComponentMemoryUsage &positions = usage[0].family == EntityManager::component_family<Position>()
+        ? usage[0] : usage[1];
+    const ComponentMemoryUsage &rares = usage[0].family == EntityManager::component_family<Rare>()
+        ? usage[0] : usage[1];
+    REQUIRE(2 == positions.count);
+    REQUIRE(1 == rares.count);
+    REQUIRE(rares.capacity >= 1);
+    REQUIRE(rares.bytes >= rares.capacity * sizeof(Rare));
+    if (storage != ComponentStorage::ARCHETYPES) {
+      // Only whole chunks of the traits' size are allocated
+      REQUIRE(4 == rares.capacity);
+      REQUIRE(positions.capacity >= 10000);
+    }
+  }
+}
+
+TEST_CASE_METHOD(EntityManagerFixture, "TestCachedViewTracksMembership") {
+  Entity a = em.create(), b = em.create(), c = em.create();
+  a.assign<Position>();
+  a.assign<Direction>();
+  b.assign<Position>();
+
+  // Registered after some entities already match
+  auto view = em.cached_view<Position, Direction>();
+  REQUIRE(1 == view.size());
+  REQUIRE(a == *view.begin());
+
+  b.assign<Direction>();
+  c.assign<Direction>();
+  REQUIRE(2 == view.size());
+  a.remove<Direction>();
+  REQUIRE(1 == view.size());
+  REQUIRE(b == *view.begin());
+  c.assign<Position>();
+  b.destroy();
+  REQUIRE(1 == view.size());
+  REQUIRE(c == *view.begin());
+
+  // Views for the same components share one list
+  size_t shared = em.cached_view<Direction, Position>().size();
+  REQUIRE(1 == shared);
+  em.reset();
+  REQUIRE(0 == view.size());
+  Entity d = em.create();
+  d.assign<Position>();
+  d.assign<Direction>();
+  REQUIRE(1 == view.size());
+}
+
+TEST_CASE("TestCachedViewMatchesView") {
+  for (ComponentStorage storage : {ComponentStorage::POOLS, ComponentStorage::SPARSE_SETS,
+                                   ComponentStorage::ARCHETYPES}) {
+    EntityX ex(storage);
+    auto view = ex.entities.cached_view<Position, Direction>();
+    for (int i = 0; i < 1000; ++i) {
+      Entity e = ex.entities.create();
+      e.assign<Position>(float(i), 0.0f);
+      if (i % 3 == 0) e.assign<Direction>(1.0f, 1.0f);
+      if (i % 5 == 0) e.remove<Position>();
+      if (i % 7 == 0) e.destroy();
+    }
+
+    set<Entity> cached, scanned;
+    for (Entity e : view) cached.insert(e);
+    for (Entity e : ex.entities.entities_with_components<Position, Direction>()) scanned.insert(e);
+    REQUIRE(cached == scanned);
+    float sum = 0.0f;
+    view.each([&](Entity entity, Position &position, Direction &) { sum += position.x; });
+    float expected = 0.0f;
+    for (Entity e : scanned) expected += e.component<Position>()->x;
+    REQUIRE(sum == expected);
+
+    // Destroying the entity being visited must not skip any other
+    size_t visited = 0;
+    for (Entity e : view) {
+      e.destroy();
+      ++visited;
+    }
+    REQUIRE(scanned.size() == visited);
+    REQUIRE(0 == view.size());
+  }
+}
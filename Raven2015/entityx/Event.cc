@@ -17,10 +17,84 @@ BaseEvent::Family BaseEvent::family_counter_ = 0;
 BaseEvent::~BaseEvent() {
 }
 
-EventManager::EventManager() {
+const std::uint64_t EventManager::UNORDERED;
+
+namespace {
+
+std::atomic<std::uint64_t> next_manager_id(1);
+
+// Each thread remembers its Stagings in the last few EventManagers it posted to.
+struct CachedStaging {
+  std::uint64_t manager;
+  void *staging;
+};
+const std::size_t STAGING_CACHE_SIZE = 4;
+thread_local CachedStaging staging_cache[STAGING_CACHE_SIZE] = {};
+thread_local std::size_t staging_cache_next = 0;
+
+}  // namespace
+
+EventManager::EventManager() : id_(next_manager_id++), stagings_(nullptr) {
 }
 
 EventManager::~EventManager() {
+  Staging *staging = stagings_.load(std::memory_order_acquire);
+  while (staging) {
+    Staging *next = staging->next;
+    delete staging;
+    staging = next;
+  }
+}
+
+void EventManager::set_producer(std::uint64_t producer) {
+  staging_().producer = producer;
+}
+
+std::uint64_t EventManager::producer() {
+  return staging_().producer;
+}
+
+EventManager::Staging &EventManager::staging_() {
+  for (const CachedStaging &cached : staging_cache) {
+    if (cached.manager == id_) return *static_cast<Staging*>(cached.staging);
+  }
+
+  // This thread's first post since its cache entry was evicted: find its Staging, or publish a
+  // new one at the head of the list.
+  const std::thread::id self = std::this_thread::get_id();
+  Staging *staging = stagings_.load(std::memory_order_acquire);
+  while (staging && staging->owner != self) staging = staging->next;
+  if (!staging) {
+    staging = new Staging(self);
+    staging->next = stagings_.load(std::memory_order_relaxed);
+    while (!stagings_.compare_exchange_weak(staging->next, staging, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+    }
+  }
+  staging_cache[staging_cache_next++ % STAGING_CACHE_SIZE] = CachedStaging{id_, staging};
+  return *staging;
+}
+
+void EventManager::dispatch_all() {
+  // Types that have only been posted have no queue yet; create theirs in family order.
+  std::size_t families = 0;
+  for (Staging *staging = stagings_.load(std::memory_order_acquire); staging; staging = staging->next) {
+    families = std::max(families, staging->events.size());
+  }
+  for (std::size_t family = 0; family < families; ++family) {
+    if (family < queues_.size() && queues_[family]) continue;
+    for (Staging *staging = stagings_.load(std::memory_order_acquire); staging; staging = staging->next) {
+      if (family < staging->events.size() && staging->events[family] && !staging->events[family]->empty()) {
+        staging->events[family]->create_queue(*this);
+        break;
+      }
+    }
+  }
+
+  // Receivers may enqueue events of new types, which are dispatched in this pass too.
+  for (std::size_t i = 0; i < queue_order_.size(); ++i) {
+    queue_order_[i]->dispatch(*this);
+  }
 }
 
 }  // namespace entityx
@@ -10,10 +10,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
 #include <list>
+#include <thread>
 #include <unordered_map>
 #include <memory>
 #include <utility>
@@ -40,6 +43,9 @@ class BaseEvent {
 typedef Simple::Signal<void (const void*)> EventSignal;
 typedef std::shared_ptr<EventSignal> EventSignalPtr;
 typedef std::weak_ptr<EventSignal> EventSignalWeakPtr;
+typedef Simple::Signal<void (const void*, std::size_t)> BatchEventSignal;
+typedef std::shared_ptr<BatchEventSignal> BatchEventSignalPtr;
+typedef std::weak_ptr<BatchEventSignal> BatchEventSignalWeakPtr;
 
 
 /**
@@ -61,6 +67,27 @@ class Event : public BaseEvent {
 };
 
 
+/**
+ * A contiguous run of events of type E, as delivered to batch receivers (see
+ * EventManager::subscribe_batch()). Only valid while it is being received.
+ */
+template <typename E>
+class EventSpan {
+ public:
+  EventSpan(const E *events, std::size_t count) : events_(events), count_(count) {}
+
+  const E *begin() const { return events_; }
+  const E *end() const { return events_ + count_; }
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  const E &operator[](std::size_t i) const { return events_[i]; }
+
+ private:
+  const E *events_;
+  std::size_t count_;
+};
+
+
 class BaseReceiver {
  public:
   virtual ~BaseReceiver() {
@@ -70,6 +97,12 @@ class BaseReceiver {
         ptr.lock()->disconnect(connection.second.second);
       }
     }
+    for (auto connection : batch_connections_) {
+      auto &ptr = connection.second.first;
+      if (!ptr.expired()) {
+        ptr.lock()->disconnect(connection.second.second);
+      }
+    }
   }
 
   // Return number of signals connected to this receiver.
@@ -80,12 +113,18 @@ class BaseReceiver {
         size++;
       }
     }
+    for (auto connection : batch_connections_) {
+      if (!connection.second.first.expired()) {
+        size++;
+      }
+    }
     return size;
   }
 
  private:
   friend class EventManager;
   std::unordered_map<BaseEvent::Family, std::pair<EventSignalWeakPtr, std::size_t>> connections_;
+  std::unordered_map<BaseEvent::Family, std::pair<BatchEventSignalWeakPtr, std::size_t>> batch_connections_;
 };
 
 
@@ -99,10 +138,20 @@ class Receiver : public BaseReceiver {
 /**
  * Handles event subscription and delivery.
  *
+ * Events are either emitted, and delivered to receivers immediately, or enqueued, and delivered
+ * when dispatch() or dispatch_all() is called. Queued events let a System raise events in the
+ * middle of iterating entities, and have them handled at a well-defined point in the frame.
+ *
+ * Only post() may be called from several threads at once. Receivers are always called on the
+ * thread that emits or dispatches.
+ *
  * Subscriptions are automatically removed when receivers are destroyed..
  */
 class EventManager : entityx::help::NonCopyable {
  public:
+  /// The producer key of events posted without one.
+  static const std::uint64_t UNORDERED = ~std::uint64_t(0);
+
   EventManager();
   virtual ~EventManager();
 
@@ -151,10 +200,53 @@ class EventManager : entityx::help::NonCopyable {
     base.connections_.erase(Event<E>::family());
   }
 
+  /**
+   * Subscribe an object to receive events of type E in batches.
+   *
+   * The receiver must implement a receive() method accepting an EventSpan<E>. It is passed every
+   * event of a dispatch<E>() at once, before they are delivered to receivers of single events;
+   * emitted events are passed as spans of one.
+   *
+   * eg.
+   *
+   *     struct DamageSystem : public Receiver<DamageSystem> {
+   *       void receive(const EventSpan<Explosion> &explosions) {
+   *         for (const Explosion &explosion : explosions) {
+   *         }
+   *       }
+   *     };
+   *
+   *     DamageSystem receiver;
+   *     em.subscribe_batch<Explosion>(receiver);
+   */
+  template <typename E, typename Receiver>
+  void subscribe_batch(Receiver &receiver) {
+    void (Receiver::*receive)(const EventSpan<E> &) = &Receiver::receive;
+    auto sig = batch_signal_for(Event<E>::family());
+    auto wrapper = BatchCallbackWrapper<E>(std::bind(receive, &receiver, std::placeholders::_1));
+    auto connection = sig->connect(wrapper);
+    BaseReceiver &base = receiver;
+    base.batch_connections_.insert(std::make_pair(Event<E>::family(), std::make_pair(BatchEventSignalWeakPtr(sig), connection)));
+  }
+
+  /**
+   * Unsubscribe an object from batches of events of type E.
+   */
+  template <typename E, typename Receiver>
+  void unsubscribe_batch(Receiver &receiver) {
+    BaseReceiver &base = receiver;
+    assert(base.batch_connections_.find(Event<E>::family()) != base.batch_connections_.end());
+    auto pair = base.batch_connections_[Event<E>::family()];
+    auto &ptr = pair.first;
+    if (!ptr.expired()) {
+      ptr.lock()->disconnect(pair.second);
+    }
+    base.batch_connections_.erase(Event<E>::family());
+  }
+
   template <typename E>
   void emit(const E &event) {
-    auto sig = signal_for(Event<E>::family());
-    sig->emit(&event);
+    deliver_(&event, 1);
   }
 
   /**
@@ -162,8 +254,7 @@ class EventManager : entityx::help::NonCopyable {
    */
   template <typename E>
   void emit(std::unique_ptr<E> event) {
-    auto sig = signal_for(Event<E>::family());
-    sig->emit(event.get());
+    deliver_(event.get(), 1);
   }
 
   /**
@@ -181,15 +272,98 @@ class EventManager : entityx::help::NonCopyable {
   void emit(Args && ... args) {
     // Using 'E event(std::forward...)' causes VS to fail with an internal error. Hack around it.
     E event = E(std::forward<Args>(args) ...);
-    auto sig = signal_for(std::size_t(Event<E>::family()));
-    sig->emit(&event);
+    deliver_(&event, 1);
+  }
+
+  /**
+   * Queue an event, constructed from args, for delivery by the next dispatch<E>() or
+   * dispatch_all().
+   *
+   * eg.
+   *
+   *     em.enqueue<Explosion>(10);
+   *     ...
+   *     em.dispatch_all();
+   */
+  template <typename E, typename ... Args>
+  void enqueue(Args && ... args) {
+    queue_for_<E>().queued.emplace_back(std::forward<Args>(args) ...);
+  }
+
+  /**
+   * Queue an event, constructed from args, from any thread, without taking locks.
+   *
+   * Each thread stages its posted events in a buffer of its own. The next dispatch<E>() or
+   * dispatch_all() merges the buffers into the queue, after the events enqueued with enqueue().
+   * Events are merged in order of their producer key (see set_producer()), then in the order they
+   * were posted, so the outcome does not depend on thread scheduling as long as each producer
+   * posts from one thread at a time. Events posted without a producer key come last, in no
+   * particular order between threads.
+   *
+   * Must not be called while events are being dispatched.
+   */
+  template <typename E, typename ... Args>
+  void post(Args && ... args) {
+    Staging &staging = staging_();
+    StagedEvents<E> &staged = staged_for_<E>(staging);
+    staged.events.emplace_back(std::forward<Args>(args) ...);
+    staged.producers.push_back(staging.producer);
   }
 
+  /**
+   * Set the producer key of the events the calling thread posts from now on, or UNORDERED.
+   *
+   * SystemScheduler sets it to the position of each System in its sequence while the System
+   * updates, and restores the previous key afterwards: a thread waiting on a ThreadPool may run
+   * another System's update in the middle of its own.
+   */
+  void set_producer(std::uint64_t producer);
+
+  /// The producer key of the events the calling thread posts.
+  std::uint64_t producer();
+
+  /// Number of events of type E waiting for dispatch, not counting posted events yet to be merged.
+  template <typename E>
+  std::size_t queued() const {
+    const std::size_t family = Event<E>::family();
+    return family < queues_.size() && queues_[family] ? queues_[family]->size() : 0;
+  }
+
+  /**
+   * Deliver the queued events of type E, in the order they were enqueued, then discard them.
+   *
+   * Batch receivers are passed all of the events as one EventSpan first, then each event is
+   * delivered to the receivers of single events. Events of type E enqueued by receivers are held
+   * for the next dispatch, and dispatch<E>() called from a receiver of E does nothing.
+   */
+  template <typename E>
+  void dispatch() {
+    const std::size_t family = Event<E>::family();
+    if (stagings_.load(std::memory_order_acquire)) merge_posted_<E>();
+    if (family >= queues_.size() || !queues_[family]) return;
+    EventQueue<E> &queue = static_cast<EventQueue<E>&>(*queues_[family]);
+    if (queue.dispatching || queue.queued.empty()) return;
+    queue.dispatching = true;
+    queue.queued.swap(queue.delivering);
+    deliver_(queue.delivering.data(), queue.delivering.size());
+    queue.delivering.clear();
+    queue.dispatching = false;
+  }
+
+  /**
+   * dispatch() every event type that has been enqueued, in the order each type was first
+   * enqueued, then posted. To control the order, call dispatch<E>() for each type instead.
+   */
+  void dispatch_all();
+
   std::size_t connected_receivers() const {
     std::size_t size = 0;
     for (EventSignalPtr handler : handlers_) {
       if (handler) size += handler->size();
     }
+    for (BatchEventSignalPtr handler : batch_handlers_) {
+      if (handler) size += handler->size();
+    }
     return size;
   }
 
@@ -202,6 +376,125 @@ class EventManager : entityx::help::NonCopyable {
     return handlers_[id];
   }
 
+  BatchEventSignalPtr &batch_signal_for(std::size_t id) {
+    if (id >= batch_handlers_.size())
+      batch_handlers_.resize(id + 1);
+    if (!batch_handlers_[id])
+      batch_handlers_[id] = std::make_shared<BatchEventSignal>();
+    return batch_handlers_[id];
+  }
+
+  // Deliver count contiguous events to the batch receivers of E, then to the receivers of single events.
+  template <typename E>
+  void deliver_(const E *events, std::size_t count) {
+    const std::size_t family = Event<E>::family();
+    if (family < batch_handlers_.size() && batch_handlers_[family]) {
+      BatchEventSignalPtr batch_sig = batch_handlers_[family];
+      batch_sig->emit(events, count);
+    }
+    auto sig = signal_for(family);
+    for (std::size_t i = 0; i < count; ++i) {
+      sig->emit(&events[i]);
+    }
+  }
+
+  struct BaseEventQueue {
+    virtual ~BaseEventQueue() {}
+    virtual void dispatch(EventManager &events) = 0;
+    virtual std::size_t size() const = 0;
+  };
+
+  // The queued events of one type. Dispatching swaps the two buffers, so both keep their capacity
+  // from frame to frame and receivers can enqueue more events while a dispatch is delivering.
+  template <typename E>
+  struct EventQueue : BaseEventQueue {
+    void dispatch(EventManager &events) override { events.dispatch<E>(); }
+    std::size_t size() const override { return queued.size(); }
+
+    std::vector<E> queued;
+    std::vector<E> delivering;
+    bool dispatching = false;
+  };
+
+  struct BaseStagedEvents {
+    virtual ~BaseStagedEvents() {}
+    virtual bool empty() const = 0;
+    // Make sure the EventManager has a queue for these events.
+    virtual void create_queue(EventManager &events) = 0;
+  };
+
+  // The events of one type posted by one thread, with the producer key of each.
+  template <typename E>
+  struct StagedEvents : BaseStagedEvents {
+    bool empty() const override { return events.empty(); }
+    void create_queue(EventManager &manager) override { manager.queue_for_<E>(); }
+
+    std::vector<E> events;
+    std::vector<std::uint64_t> producers;
+  };
+
+  // The events posted by one thread, by family. Only the owning thread posts into it.
+  struct Staging {
+    explicit Staging(std::thread::id owner) : owner(owner) {}
+
+    std::thread::id owner;
+    Staging *next = nullptr;
+    std::uint64_t producer = UNORDERED;
+    std::vector<std::unique_ptr<BaseStagedEvents>> events;
+  };
+
+  // The calling thread's Staging, creating it on the thread's first post.
+  Staging &staging_();
+
+  template <typename E>
+  StagedEvents<E> &staged_for_(Staging &staging) {
+    const std::size_t family = Event<E>::family();
+    if (family >= staging.events.size())
+      staging.events.resize(family + 1);
+    if (!staging.events[family])
+      staging.events[family].reset(new StagedEvents<E>());
+    return static_cast<StagedEvents<E>&>(*staging.events[family]);
+  }
+
+  // Move every thread's posted events of type E into its queue, ordered by producer.
+  template <typename E>
+  void merge_posted_() {
+    const std::size_t family = Event<E>::family();
+    std::vector<StagedEvents<E>*> staged;
+    std::vector<std::pair<std::uint64_t, std::pair<std::size_t, std::size_t>>> order;
+    for (Staging *staging = stagings_.load(std::memory_order_acquire); staging; staging = staging->next) {
+      if (family >= staging->events.size() || !staging->events[family]) continue;
+      StagedEvents<E> &events = static_cast<StagedEvents<E>&>(*staging->events[family]);
+      for (std::size_t i = 0; i < events.events.size(); ++i) {
+        order.push_back(std::make_pair(events.producers[i], std::make_pair(staged.size(), i)));
+      }
+      staged.push_back(&events);
+    }
+    if (order.empty()) return;
+
+    std::sort(order.begin(), order.end());
+    std::vector<E> &queued = queue_for_<E>().queued;
+    for (auto &event : order) {
+      queued.push_back(std::move(staged[event.second.first]->events[event.second.second]));
+    }
+    for (StagedEvents<E> *events : staged) {
+      events->events.clear();
+      events->producers.clear();
+    }
+  }
+
+  template <typename E>
+  EventQueue<E> &queue_for_() {
+    const std::size_t family = Event<E>::family();
+    if (family >= queues_.size())
+      queues_.resize(family + 1);
+    if (!queues_[family]) {
+      queues_[family].reset(new EventQueue<E>());
+      queue_order_.push_back(queues_[family].get());
+    }
+    return static_cast<EventQueue<E>&>(*queues_[family]);
+  }
+
   // Functor used as an event signal callback that casts to E.
   template <typename E>
   struct EventCallbackWrapper {
@@ -210,7 +503,25 @@ class EventManager : entityx::help::NonCopyable {
     std::function<void(const E &)> callback;
   };
 
+  // Functor used as a batch event signal callback that casts to a span of E.
+  template <typename E>
+  struct BatchCallbackWrapper {
+    explicit BatchCallbackWrapper(std::function<void(const EventSpan<E> &)> callback) : callback(callback) {}
+    void operator()(const void *events, std::size_t count) {
+      callback(EventSpan<E>(static_cast<const E*>(events), count));
+    }
+    std::function<void(const EventSpan<E> &)> callback;
+  };
+
   std::vector<EventSignalPtr> handlers_;
+  std::vector<BatchEventSignalPtr> batch_handlers_;
+  // Queued events by family, and the same queues in the order dispatch_all() visits them.
+  std::vector<std::unique_ptr<BaseEventQueue>> queues_;
+  std::vector<BaseEventQueue*> queue_order_;
+  // Identifies this EventManager in each thread's cache of Stagings, as addresses may be reused.
+  const std::uint64_t id_;
+  // One Staging per thread that has posted, pushed with compare-and-swap.
+  std::atomic<Staging*> stagings_;
 };
 
 }  // namespace entityx
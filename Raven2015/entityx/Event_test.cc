@@ -11,6 +11,7 @@
 #define CATCH_CONFIG_MAIN
 
 #include <string>
+#include <thread>
 #include <vector>
 #include "entityx/3rdparty/catch.hpp"
 #include "entityx/Event.h"
@@ -107,3 +108,145 @@ TEST_CASE("TestUnsubscription") {
     REQUIRE(explosion_system.damage_received == 1);
   }
 }
+
+struct BatchSystem : public Receiver<BatchSystem> {
+  void receive(const entityx::EventSpan<Explosion> &explosions) {
+    batch_sizes.push_back(explosions.size());
+    for (const Explosion &explosion : explosions) {
+      log.push_back("batch " + std::to_string(explosion.damage));
+    }
+  }
+
+  void receive(const Explosion &explosion) {
+    log.push_back("single " + std::to_string(explosion.damage));
+    // Chain a follow-up event; it waits for the next dispatch.
+    if (events && explosion.damage < 10) events->enqueue<Explosion>(explosion.damage * 10);
+  }
+
+  void receive(const Collision &collision) {
+    log.push_back("collision " + std::to_string(collision.damage));
+  }
+
+  EventManager *events = nullptr;
+  std::vector<std::size_t> batch_sizes;
+  std::vector<std::string> log;
+};
+
+TEST_CASE("TestEnqueueDispatch") {
+  EventManager em;
+  ExplosionSystem explosion_system;
+  em.subscribe<Explosion>(explosion_system);
+  em.enqueue<Explosion>(10);
+  em.enqueue<Explosion>(5);
+  REQUIRE(2 == em.queued<Explosion>());
+  REQUIRE(0 == em.queued<Collision>());
+  REQUIRE(0 == explosion_system.damage_received);
+
+  em.dispatch<Collision>();
+  REQUIRE(0 == explosion_system.damage_received);
+  em.dispatch<Explosion>();
+  REQUIRE(15 == explosion_system.damage_received);
+  REQUIRE(0 == em.queued<Explosion>());
+  em.dispatch<Explosion>();
+  REQUIRE(15 == explosion_system.damage_received);
+}
+
+TEST_CASE("TestBatchReceiver") {
+  EventManager em;
+  BatchSystem batch_system;
+  batch_system.events = &em;
+  em.subscribe_batch<Explosion>(batch_system);
+  em.subscribe<Explosion>(batch_system);
+  em.subscribe<Collision>(batch_system);
+  REQUIRE(3 == em.connected_receivers());
+  REQUIRE(3 == batch_system.connected_signals());
+
+  // A batch receives a dispatch's events at once, before receivers of single events
+  em.enqueue<Collision>(3);
+  em.enqueue<Explosion>(1);
+  em.enqueue<Explosion>(2);
+  em.dispatch_all();
+  std::vector<std::string> expected = {"collision 3", "batch 1", "batch 2", "single 1", "single 2"};
+  REQUIRE(expected == batch_system.log);
+  REQUIRE(2 == em.queued<Explosion>());
+
+  batch_system.log.clear();
+  em.dispatch_all();
+  expected = {"batch 10", "batch 20", "single 10", "single 20"};
+  REQUIRE(expected == batch_system.log);
+  REQUIRE(0 == em.queued<Explosion>());
+
+  // Emitted events arrive as batches of one
+  batch_system.events = nullptr;
+  em.emit<Explosion>(7);
+  REQUIRE(3 == batch_system.batch_sizes.size());
+  REQUIRE(1 == batch_system.batch_sizes.back());
+
+  em.unsubscribe_batch<Explosion>(batch_system);
+  REQUIRE(2 == em.connected_receivers());
+  em.emit<Explosion>(8);
+  REQUIRE(3 == batch_system.batch_sizes.size());
+}
+
+TEST_CASE("TestBatchReceiverExpired") {
+  EventManager em;
+  {
+    BatchSystem batch_system;
+    em.subscribe_batch<Explosion>(batch_system);
+    REQUIRE(1 == em.connected_receivers());
+  }
+  REQUIRE(0 == em.connected_receivers());
+  em.enqueue<Explosion>(1);
+  em.dispatch_all();
+}
+
+struct ExplosionLog : public Receiver<ExplosionLog> {
+  void receive(const Explosion &explosion) { damage.push_back(explosion.damage); }
+
+  std::vector<int> damage;
+};
+
+TEST_CASE("TestPostFromManyThreads") {
+  EventManager em;
+  ExplosionLog log;
+  em.subscribe<Explosion>(log);
+  em.enqueue<Explosion>(-1);
+
+  // Each thread posts as two producers, in reverse order of their keys
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&em, t] {
+      for (int producer = 1; producer >= 0; --producer) {
+        em.set_producer(std::uint64_t(producer * 4 + t));
+        for (int i = 0; i < 100; ++i) em.post<Explosion>((producer * 4 + t) * 1000 + i);
+      }
+      em.set_producer(EventManager::UNORDERED);
+    });
+  }
+  for (std::thread &thread : threads) thread.join();
+  REQUIRE(1 == em.queued<Explosion>());
+  REQUIRE(log.damage.empty());
+
+  // Enqueued events come first, then posted ones by producer, each in the order it posted
+  em.dispatch<Explosion>();
+  REQUIRE(801 == log.damage.size());
+  REQUIRE(-1 == log.damage[0]);
+  for (std::size_t i = 1; i < log.damage.size(); ++i) {
+    REQUIRE(int((i - 1) / 100 * 1000 + (i - 1) % 100) == log.damage[i]);
+  }
+  em.dispatch<Explosion>();
+  REQUIRE(801 == log.damage.size());
+}
+
+TEST_CASE("TestDispatchAllDeliversPostedEvents") {
+  EventManager em;
+  ExplosionSystem explosion_system;
+  em.subscribe<Collision>(explosion_system);
+  std::thread producer([&em] { em.post<Collision>(4); });
+  producer.join();
+  em.post<Collision>(3);
+  em.dispatch_all();
+  REQUIRE(7 == explosion_system.damage_received);
+  em.dispatch_all();
+  REQUIRE(7 == explosion_system.damage_received);
+}
@@ -12,6 +12,24 @@
 
 namespace entityx {
 
+namespace {
+
+// Sets the calling thread's producer key for a scope, then restores the previous one.
+class ProducerScope {
+ public:
+  ProducerScope(EventManager &events, std::uint64_t producer)
+      : events_(events), previous_(events.producer()) {
+    events_.set_producer(producer);
+  }
+  ~ProducerScope() { events_.set_producer(previous_); }
+
+ private:
+  EventManager &events_;
+  const std::uint64_t previous_;
+};
+
+}  // namespace
+
 BaseSystem::Family BaseSystem::family_counter_;
 
 BaseSystem::~BaseSystem() {
@@ -31,4 +49,63 @@ void SystemManager::configure() {
   initialized_ = true;
 }
 
+void SystemScheduler::add(std::shared_ptr<BaseSystem> system) {
+  systems_.push_back(system);
+  access_.resize(systems_.size());
+  dependencies_.resize(systems_.size());
+  dependents_.resize(systems_.size());
+  remaining_.reset(new std::atomic<size_t>[systems_.size()]);
+}
+
+void SystemScheduler::update(TimeDelta dt) {
+  // Each System waits for every earlier System it conflicts with
+  for (size_t i = 0; i < systems_.size(); ++i) {
+    access_[i].reset();
+    systems_[i]->access(access_[i]);
+    dependencies_[i].clear();
+    dependents_[i].clear();
+    for (size_t j = 0; j < i; ++j) {
+      if (access_[i].conflicts_with(access_[j])) {
+        dependencies_[i].push_back(j);
+        dependents_[j].push_back(i);
+      }
+    }
+  }
+
+  if (serial_ || !pool_ || pool_->size() == 0) {
+    for (size_t i = 0; i < systems_.size(); ++i) {
+      update_system(i, dt);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < systems_.size(); ++i) {
+    remaining_[i] = dependencies_[i].size();
+  }
+  for (size_t i = 0; i < systems_.size(); ++i) {
+    if (dependencies_[i].empty()) {
+      pool_->submit([this, i, dt] { run(i, dt); });
+    }
+  }
+  pool_->wait();
+}
+
+// Updates a System, then releases each dependent whose last dependency this was.
+void SystemScheduler::run(size_t index, TimeDelta dt) {
+  update_system(index, dt);
+  for (size_t dependent : dependents_[index]) {
+    if (--remaining_[dependent] == 0) {
+      pool_->submit([this, dependent, dt] { run(dependent, dt); });
+    }
+  }
+}
+
+void SystemScheduler::update_system(size_t index, TimeDelta dt) {
+  // Order the events the System posts by its place in the sequence, whichever thread it runs on.
+  // The thread may be running this System while another waits on the pool further up its stack,
+  // so the waiting System's key is put back afterwards.
+  ProducerScope producer(event_manager_, index);
+  systems_[index]->update(entity_manager_, event_manager_, dt);
+}
+
 }  // namespace entityx
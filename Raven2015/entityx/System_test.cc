@@ -10,7 +10,9 @@
 
 #define CATCH_CONFIG_MAIN
 
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include "entityx/3rdparty/catch.hpp"
 #include "entityx/System.h"
@@ -68,6 +70,44 @@ public:
   }
 };
 
+class ScheduledMovementSystem : public MovementSystem {
+ public:
+  void access(ComponentAccess &access) const override {
+    access.reads<Direction>().writes<Position>();
+  }
+};
+
+class ScheduledCounterSystem : public CounterSystem {
+ public:
+  void access(ComponentAccess &access) const override {
+    access.writes<Counter>();
+  }
+};
+
+// Records the order in which the instances ran and on which threads.
+class RecordingSystem : public System<RecordingSystem> {
+ public:
+  RecordingSystem(int id, std::vector<int> &order, std::mutex &mutex, bool writes_position)
+      : id(id), order(order), mutex(mutex), writes_position(writes_position) {}
+
+  void update(EntityManager &es, EventManager &events, TimeDelta) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(id);
+    thread = std::this_thread::get_id();
+  }
+
+  void access(ComponentAccess &access) const override {
+    if (writes_position) access.writes<Position>();
+    else access.reads<Counter>();
+  }
+
+  int id;
+  std::vector<int> &order;
+  std::mutex &mutex;
+  bool writes_position;
+  std::thread::id thread;
+};
+
 class EntitiesFixture : public EntityX {
  public:
   std::vector<Entity> created_entities;
@@ -131,3 +171,166 @@ TEST_CASE_METHOD(EntitiesFixture, "TestApplyAllSystems") {
     REQUIRE(1 == counter->counter);
   }
 }
+
+TEST_CASE("TestComponentAccessConflicts") {
+  ComponentAccess reader, other_reader, writer, exclusive;
+  reader.reads<Position>();
+  other_reader.reads<Position, Direction>();
+  writer.writes<Position>();
+  exclusive.exclusive();
+
+  REQUIRE(!reader.conflicts_with(other_reader));
+  REQUIRE(reader.conflicts_with(writer));
+  REQUIRE(writer.conflicts_with(reader));
+  REQUIRE(writer.conflicts_with(writer));
+  REQUIRE(exclusive.conflicts_with(ComponentAccess()));
+  REQUIRE(!ComponentAccess().conflicts_with(reader));
+}
+
+TEST_CASE_METHOD(EntitiesFixture, "TestSchedulerAppliesAllSystems") {
+  help::ThreadPool pool(2);
+  SystemScheduler scheduler(entities, events, &pool);
+  scheduler.add(std::make_shared<ScheduledMovementSystem>());
+  scheduler.add(std::make_shared<ScheduledCounterSystem>());
+  scheduler.update(0.0);
+
+  REQUIRE(scheduler.dependencies()[1].empty());
+  Position::Handle position;
+  Direction::Handle direction;
+  Counter::Handle counter;
+  for (auto entity : created_entities) {
+    entity.unpack<Position, Direction, Counter>(position, direction, counter);
+    if (position && direction) {
+      REQUIRE(2.0 == Approx(position->x));
+      REQUIRE(3.0 == Approx(position->y));
+    }
+    REQUIRE(1 == counter->counter);
+  }
+}
+
+TEST_CASE_METHOD(EntitiesFixture, "TestSchedulerKeepsConflictingSystemsInOrder") {
+  help::ThreadPool pool(3);
+  SystemScheduler scheduler(entities, events, &pool);
+  std::vector<int> order;
+  std::mutex mutex;
+  for (int id = 0; id < 6; ++id) {
+    scheduler.add(std::make_shared<RecordingSystem>(id, order, mutex, id % 2 == 0));
+  }
+  // An undeclared System is exclusive and waits for everything before it
+  scheduler.add(std::make_shared<MovementSystem>());
+
+  for (int tick = 0; tick < 20; ++tick) {
+    order.clear();
+    scheduler.update(0.0);
+    REQUIRE(6 == order.size());
+    std::vector<int> writers;
+    for (int id : order) {
+      if (id % 2 == 0) writers.push_back(id);
+    }
+    REQUIRE((std::vector<int>{0, 2, 4}) == writers);
+  }
+  REQUIRE((std::vector<size_t>{0, 2}) == scheduler.dependencies()[4]);
+  REQUIRE(6 == scheduler.dependencies()[6].size());
+}
+
+TEST_CASE_METHOD(EntitiesFixture, "TestSchedulerSerialFallback") {
+  help::ThreadPool pool(3);
+  SystemScheduler scheduler(entities, events, &pool);
+  scheduler.set_serial(true);
+  std::vector<int> order;
+  std::mutex mutex;
+  std::vector<std::shared_ptr<RecordingSystem>> recorders;
+  for (int id = 0; id < 5; ++id) {
+    recorders.push_back(std::make_shared<RecordingSystem>(id, order, mutex, false));
+    scheduler.add(recorders.back());
+  }
+  scheduler.update(0.0);
+
+  REQUIRE((std::vector<int>{0, 1, 2, 3, 4}) == order);
+  for (auto &recorder : recorders) {
+    REQUIRE(std::this_thread::get_id() == recorder->thread);
+  }
+}
+
+struct Tick {
+  explicit Tick(int system) : system(system) {}
+  int system;
+};
+
+// Posts a few events, from whichever thread the scheduler runs it on.
+class PostingSystem : public System<PostingSystem> {
+ public:
+  explicit PostingSystem(int id) : id(id) {}
+
+  void update(EntityManager &es, EventManager &events, TimeDelta) override {
+    for (int i = 0; i < 3; ++i) events.post<Tick>(id);
+  }
+
+  void access(ComponentAccess &access) const override {
+    access.reads<Counter>();
+  }
+
+  int id;
+};
+
+struct TickLog : public Receiver<TickLog> {
+  void receive(const Tick &tick) { systems.push_back(tick.system); }
+
+  std::vector<int> systems;
+};
+
+TEST_CASE_METHOD(EntitiesFixture, "TestSchedulerOrdersPostedEvents") {
+  help::ThreadPool pool(3);
+  SystemScheduler scheduler(entities, events, &pool);
+  for (int id = 0; id < 4; ++id) {
+    scheduler.add(std::make_shared<PostingSystem>(id));
+  }
+  TickLog log;
+  events.subscribe<Tick>(log);
+  const std::vector<int> expected = {0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3};
+
+  for (int tick = 0; tick < 20; ++tick) {
+    log.systems.clear();
+    scheduler.set_serial(tick % 2 == 1);
+    scheduler.update(0.0);
+    events.dispatch_all();
+    REQUIRE(expected == log.systems);
+  }
+}
+
+// Posts an event, waits on a parallel_for over the scheduler's own pool, then posts again.
+class NestingSystem : public System<NestingSystem> {
+ public:
+  NestingSystem(int id, help::ThreadPool &pool) : id(id), pool(pool) {}
+
+  void update(EntityManager &es, EventManager &events, TimeDelta) override {
+    events.post<Tick>(id);
+    // While waiting, this thread may run the update of another System queued on the pool.
+    pool.parallel_for(64, [](std::size_t) {});
+    events.post<Tick>(id);
+  }
+
+  void access(ComponentAccess &access) const override {
+    access.reads<Counter>();
+  }
+
+  int id;
+  help::ThreadPool &pool;
+};
+
+TEST_CASE_METHOD(EntitiesFixture, "TestSchedulerOrdersEventsPostedAroundNestedWork") {
+  help::ThreadPool pool(1);
+  SystemScheduler scheduler(entities, events, &pool);
+  scheduler.add(std::make_shared<NestingSystem>(0, pool));
+  scheduler.add(std::make_shared<PostingSystem>(1));
+  TickLog log;
+  events.subscribe<Tick>(log);
+  const std::vector<int> expected = {0, 0, 1, 1, 1};
+
+  for (int tick = 0; tick < 200; ++tick) {
+    log.systems.clear();
+    scheduler.update(0.0);
+    events.dispatch_all();
+    REQUIRE(expected == log.systems);
+  }
+}
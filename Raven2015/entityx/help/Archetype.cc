@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#include "entityx/help/Archetype.h"
+
+namespace entityx {
+
+const std::size_t Archetype::NO_COLUMN;
+
+Archetype::Archetype(const ComponentMask &mask, const std::vector<const ComponentOps*> &ops,
+                     std::size_t chunk_rows)
+    : mask_(mask), chunk_rows_(chunk_rows), column_by_family_(entityx::MAX_COMPONENTS, NO_COLUMN) {
+  for (std::size_t family = 0; family < entityx::MAX_COMPONENTS; ++family) {
+    if (!mask_.test(family)) continue;
+    assert(family < ops.size() && ops[family] && "Archetype built for a component without ComponentOps");
+    column_by_family_[family] = columns_.size();
+    columns_.push_back(Column{family, ops[family], {}});
+  }
+}
+
+Archetype::~Archetype() {
+  for (Column &column : columns_) {
+    for (char *ptr : column.blocks) {
+      delete[] ptr;
+    }
+  }
+}
+
+std::size_t Archetype::push(std::uint32_t entity) {
+  if (entities_.size() == capacity_) {
+    for (Column &column : columns_) {
+      column.blocks.push_back(new char[column.ops->size * chunk_rows_]);
+    }
+    capacity_ += chunk_rows_;
+  }
+  entities_.push_back(entity);
+  return entities_.size() - 1;
+}
+
+std::size_t Archetype::migrate(std::size_t row, Archetype &to) {
+  assert(&to != this);
+  const std::size_t to_row = to.push(entities_[row]);
+  for (std::size_t c = 0; c < columns_.size(); ++c) {
+    const ComponentOps *ops = columns_[c].ops;
+    const std::size_t to_column = to.column(columns_[c].family);
+    if (to_column == NO_COLUMN) {
+      ops->destroy(get(c, row));
+    } else {
+      ops->relocate(to.get(to_column, to_row), get(c, row));
+    }
+  }
+  return to_row;
+}
+
+void Archetype::destroy(std::size_t row) {
+  for (std::size_t c = 0; c < columns_.size(); ++c) {
+    columns_[c].ops->destroy(get(c, row));
+  }
+}
+
+std::uint32_t Archetype::erase(std::size_t row) {
+  assert(row < size());
+  const std::size_t last = entities_.size() - 1;
+  const std::uint32_t moved = entities_[last];
+  if (row != last) {
+    for (std::size_t c = 0; c < columns_.size(); ++c) {
+      columns_[c].ops->relocate(get(c, row), get(c, last));
+    }
+    entities_[row] = moved;
+  }
+  entities_.pop_back();
+  return moved;
+}
+
+}  // namespace entityx
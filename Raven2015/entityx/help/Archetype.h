@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "entityx/config.h"
+#include "entityx/help/ComponentOps.h"
+#include "entityx/help/NonCopyable.h"
+
+namespace entityx {
+
+/**
+ * Stores the components of every entity with exactly the same set of
+ * components, as a structure of arrays: one column per component type, each
+ * split into chunks of chunk_rows() rows.
+ *
+ * Rows are kept packed, so erasing a row moves the last row into its place.
+ * Chunks themselves never move, so appending a row does not move the others.
+ *
+ * Component destructors *must* be called by owner, through destroy() or
+ * migrate().
+ */
+class Archetype : entityx::help::NonCopyable {
+ public:
+  typedef std::bitset<entityx::MAX_COMPONENTS> ComponentMask;
+  static const std::size_t NO_COLUMN = ~std::size_t(0);
+
+  /// ops must hold the ComponentOps of every component family in mask, indexed by family.
+  Archetype(const ComponentMask &mask, const std::vector<const ComponentOps*> &ops,
+            std::size_t chunk_rows = 256);
+  ~Archetype();
+
+  const ComponentMask &mask() const { return mask_; }
+  std::size_t size() const { return entities_.size(); }
+  std::size_t capacity() const { return capacity_; }
+  std::size_t chunk_rows() const { return chunk_rows_; }
+  std::size_t chunks() const { return (size() + chunk_rows_ - 1) / chunk_rows_; }
+  std::size_t columns() const { return columns_.size(); }
+
+  /// Number of rows in use in the given chunk.
+  std::size_t chunk_size(std::size_t chunk) const {
+    return std::min(chunk_rows_, size() - chunk * chunk_rows_);
+  }
+
+  /// The column holding the given component family, or NO_COLUMN.
+  std::size_t column(std::size_t family) const { return column_by_family_[family]; }
+
+  /// The index of the entity stored in a row.
+  std::uint32_t entity(std::size_t row) const { return entities_[row]; }
+
+  inline void *get(std::size_t column, std::size_t row) {
+    assert(row < size());
+    const Column &c = columns_[column];
+    return c.blocks[row / chunk_rows_] + (row % chunk_rows_) * c.ops->size;
+  }
+
+  inline const void *get(std::size_t column, std::size_t row) const {
+    assert(row < size());
+    const Column &c = columns_[column];
+    return c.blocks[row / chunk_rows_] + (row % chunk_rows_) * c.ops->size;
+  }
+
+  /// The first row of a chunk of a column. The rows of a chunk are contiguous.
+  inline void *chunk(std::size_t column, std::size_t chunk) {
+    return columns_[column].blocks[chunk];
+  }
+
+  /// Append a row for an entity, leaving its components uninitialised. Returns the new row.
+  std::size_t push(std::uint32_t entity);
+
+  /**
+   * Append a row for the entity in row to another Archetype, relocate the
+   * components the two Archetypes share into it and destroy the rest.
+   *
+   * The row itself is left in place, with no live components; erase() it next.
+   *
+   * @returns The entity's row in to.
+   */
+  std::size_t migrate(std::size_t row, Archetype &to);
+
+  /// Destroy the components of a row. erase() it next.
+  void destroy(std::size_t row);
+
+  /**
+   * Remove a row whose components have been destroyed or migrated, by
+   * relocating the last row into it.
+   *
+   * @returns The index of the entity that was moved into row, or of the
+   * erased entity if row was the last one.
+   */
+  std::uint32_t erase(std::size_t row);
+
+ private:
+  struct Column {
+    std::size_t family;
+    const ComponentOps *ops;
+    std::vector<char *> blocks;
+  };
+
+  ComponentMask mask_;
+  std::size_t chunk_rows_;
+  std::size_t capacity_ = 0;
+  std::vector<Column> columns_;
+  std::vector<std::size_t> column_by_family_;
+  std::vector<std::uint32_t> entities_;
+};
+
+}  // namespace entityx
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <vector>
+#include "entityx/3rdparty/catch.hpp"
+#include "entityx/help/Archetype.h"
+
+struct Position {
+  explicit Position(float x = 0.0f) : x(x) {}
+
+  float x;
+};
+
+struct Health {
+  explicit Health(int hp = 0) : hp(hp) {}
+
+  int hp;
+};
+
+
+TEST_CASE("TestArchetypeChunks") {
+  std::vector<const entityx::ComponentOps*> ops = {entityx::component_ops<Position>()};
+  entityx::Archetype::ComponentMask mask;
+  mask.set(0);
+  entityx::Archetype archetype(mask, ops, 4);
+  REQUIRE(1 == archetype.columns());
+  REQUIRE(0 == archetype.column(0));
+  REQUIRE(entityx::Archetype::NO_COLUMN == archetype.column(1));
+  REQUIRE(0 == archetype.chunks());
+
+  for (std::uint32_t i = 0; i < 6; ++i) {
+    new(archetype.get(0, archetype.push(i))) Position(float(i));
+  }
+  REQUIRE(6 == archetype.size());
+  REQUIRE(8 == archetype.capacity());
+  REQUIRE(2 == archetype.chunks());
+  REQUIRE(4 == archetype.chunk_size(0));
+  REQUIRE(2 == archetype.chunk_size(1));
+  REQUIRE(5.0f == static_cast<Position*>(archetype.chunk(0, 1))[1].x);
+
+  // Erasing moves the last row into the hole
+  archetype.destroy(1);
+  REQUIRE(5 == archetype.erase(1));
+  REQUIRE(5 == archetype.size());
+  REQUIRE(5 == archetype.entity(1));
+  REQUIRE(5.0f == static_cast<Position*>(archetype.get(0, 1))->x);
+  for (std::size_t row = 0; row < archetype.size(); ++row) archetype.destroy(row);
+}
+
+TEST_CASE("TestArchetypeMigrate") {
+  std::vector<const entityx::ComponentOps*> ops = {
+    entityx::component_ops<Position>(), entityx::component_ops<Health>()};
+  entityx::Archetype::ComponentMask position, both;
+  position.set(0);
+  both.set(0).set(1);
+  entityx::Archetype from(position, ops), to(both, ops);
+
+  new(from.get(0, from.push(7))) Position(1.0f);
+  new(from.get(0, from.push(8))) Position(2.0f);
+
+  std::size_t row = from.migrate(0, to);
+  new(to.get(to.column(1), row)) Health(10);
+  REQUIRE(8 == from.erase(0));
+  REQUIRE(1 == from.size());
+  REQUIRE(2.0f == static_cast<Position*>(from.get(0, 0))->x);
+  REQUIRE(7 == to.entity(row));
+  REQUIRE(1.0f == static_cast<Position*>(to.get(to.column(0), row))->x);
+  REQUIRE(10 == static_cast<Health*>(to.get(to.column(1), row))->hp);
+}
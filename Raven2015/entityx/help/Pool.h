@@ -35,6 +35,9 @@ class BasePool {
   std::size_t size() const { return size_; }
   std::size_t capacity() const { return capacity_; }
   std::size_t chunks() const { return blocks_.size(); }
+  std::size_t chunk_size() const { return chunk_size_; }
+  /// Bytes allocated for elements.
+  std::size_t memory() const { return capacity_ * element_size_; }
 
   /// Ensure at least n elements will fit in the pool.
   inline void expand(std::size_t n) {
@@ -80,7 +83,7 @@ class BasePool {
 template <typename T, std::size_t ChunkSize = 8192>
 class Pool : public BasePool {
  public:
-  Pool() : BasePool(sizeof(T), ChunkSize) {}
+  explicit Pool(std::size_t chunk_size = ChunkSize) : BasePool(sizeof(T), chunk_size) {}
   virtual ~Pool() {
     // Component destructors *must* be called by owner.
   }
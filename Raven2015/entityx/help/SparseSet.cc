@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#include "entityx/help/SparseSet.h"
+
+namespace entityx {
+
+const std::uint32_t SparseSet::ABSENT;
+
+SparseSet::SparseSet(const ComponentOps *ops, std::size_t chunk_rows)
+    : ops_(ops), chunk_rows_(chunk_rows) {
+}
+
+SparseSet::~SparseSet() {
+  for (char *ptr : blocks_) {
+    delete[] ptr;
+  }
+}
+
+void SparseSet::reserve(std::size_t n) {
+  while (capacity() < n) {
+    blocks_.push_back(new char[ops_->size * chunk_rows_]);
+  }
+  entities_.reserve(n);
+}
+
+void *SparseSet::insert(std::uint32_t entity) {
+  assert(!contains(entity));
+  if (entity >= sparse_.size()) {
+    sparse_.resize(entity + 1, ABSENT);
+  }
+  if (size() == capacity()) {
+    blocks_.push_back(new char[ops_->size * chunk_rows_]);
+  }
+  sparse_[entity] = std::uint32_t(entities_.size());
+  entities_.push_back(entity);
+  return at(entities_.size() - 1);
+}
+
+void SparseSet::erase(std::uint32_t entity) {
+  assert(contains(entity));
+  const std::uint32_t position = sparse_[entity];
+  const std::uint32_t last = std::uint32_t(entities_.size() - 1);
+  ops_->destroy(at(position));
+  if (position != last) {
+    ops_->relocate(at(position), at(last));
+    entities_[position] = entities_[last];
+    sparse_[entities_[position]] = position;
+  }
+  entities_.pop_back();
+  sparse_[entity] = ABSENT;
+}
+
+}  // namespace entityx
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "entityx/help/ComponentOps.h"
+#include "entityx/help/NonCopyable.h"
+
+namespace entityx {
+
+/**
+ * Stores the components of one type for only the entities that have one.
+ *
+ * A sparse array indexed by entity points into a packed ("dense") array of
+ * components, alongside a packed list of the entities owning them, so
+ * iterating a component type is a linear scan with no holes.
+ *
+ * The dense array is split into chunks of chunk_rows() components, which are
+ * never moved, so inserting does not move other components. Erasing moves
+ * the last component into the erased one's place.
+ *
+ * Lookups, inserts and erases are O(1).
+ */
+class SparseSet : entityx::help::NonCopyable {
+ public:
+  static const std::uint32_t ABSENT = ~std::uint32_t(0);
+
+  explicit SparseSet(const ComponentOps *ops, std::size_t chunk_rows = 1024);
+  /// Frees memory only; component destructors *must* be called by owner, through erase().
+  ~SparseSet();
+
+  std::size_t size() const { return entities_.size(); }
+  std::size_t capacity() const { return blocks_.size() * chunk_rows_; }
+  std::size_t chunk_rows() const { return chunk_rows_; }
+  std::size_t chunks() const { return (size() + chunk_rows_ - 1) / chunk_rows_; }
+
+  /// Bytes allocated, for components and for the sparse and packed entity indices.
+  std::size_t memory() const {
+    return capacity() * ops_->size + (sparse_.capacity() + entities_.capacity()) * sizeof(std::uint32_t);
+  }
+
+  /// Number of components in use in the given chunk.
+  std::size_t chunk_size(std::size_t chunk) const {
+    return std::min(chunk_rows_, size() - chunk * chunk_rows_);
+  }
+
+  bool contains(std::uint32_t entity) const {
+    return entity < sparse_.size() && sparse_[entity] != ABSENT;
+  }
+
+  /// The entity owning the component at a dense position.
+  std::uint32_t entity(std::size_t position) const { return entities_[position]; }
+
+  inline void *get(std::uint32_t entity) {
+    assert(contains(entity));
+    return at(sparse_[entity]);
+  }
+
+  inline const void *get(std::uint32_t entity) const {
+    assert(contains(entity));
+    return at(sparse_[entity]);
+  }
+
+  /// The entity's component, or nullptr if it has none.
+  inline void *find(std::uint32_t entity) {
+    return contains(entity) ? at(sparse_[entity]) : nullptr;
+  }
+
+  inline void *at(std::size_t position) {
+    return blocks_[position / chunk_rows_] + (position % chunk_rows_) * ops_->size;
+  }
+
+  inline const void *at(std::size_t position) const {
+    return blocks_[position / chunk_rows_] + (position % chunk_rows_) * ops_->size;
+  }
+
+  /// The first component of a chunk. The components of a chunk are contiguous.
+  inline void *chunk(std::size_t chunk) { return blocks_[chunk]; }
+
+  /// Ensure at least n components will fit without allocating.
+  void reserve(std::size_t n);
+
+  /// Add an entity, returning uninitialised memory for its component.
+  void *insert(std::uint32_t entity);
+
+  /// Destroy an entity's component and move the last component into its place.
+  void erase(std::uint32_t entity);
+
+ private:
+  const ComponentOps *ops_;
+  std::size_t chunk_rows_;
+  std::vector<char *> blocks_;
+  // Dense position of each entity's component, or ABSENT. Index into the vector is the entity.
+  std::vector<std::uint32_t> sparse_;
+  // The entity owning each component, in dense order.
+  std::vector<std::uint32_t> entities_;
+};
+
+}  // namespace entityx
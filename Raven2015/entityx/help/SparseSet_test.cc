@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ *
+ * Author: Alec Thomas <alec@swapoff.org>
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include "entityx/3rdparty/catch.hpp"
+#include "entityx/help/SparseSet.h"
+
+struct Position {
+  explicit Position(float x = 0.0f) : x(x) {}
+
+  float x;
+};
+
+
+TEST_CASE("TestSparseSetInsertErase") {
+  entityx::SparseSet set(entityx::component_ops<Position>(), 4);
+  REQUIRE(!set.contains(3));
+
+  // Sparse entity indices end up packed
+  for (std::uint32_t entity = 0; entity < 60; entity += 10) {
+    new(set.insert(entity)) Position(float(entity));
+  }
+  REQUIRE(6 == set.size());
+  REQUIRE(8 == set.capacity());
+  REQUIRE(2 == set.chunks());
+  REQUIRE(2 == set.chunk_size(1));
+  REQUIRE(set.contains(30));
+  REQUIRE(!set.contains(31));
+  REQUIRE(!set.contains(1000));
+  REQUIRE(30.0f == static_cast<Position*>(set.get(30))->x);
+  REQUIRE(50.0f == static_cast<Position*>(set.chunk(1))[1].x);
+
+  // Erasing moves the last component into the hole
+  set.erase(10);
+  REQUIRE(5 == set.size());
+  REQUIRE(!set.contains(10));
+  REQUIRE(50 == set.entity(1));
+  REQUIRE(50.0f == static_cast<Position*>(set.get(50))->x);
+  REQUIRE(50.0f == static_cast<Position*>(set.at(1))->x);
+
+  set.erase(50);
+  set.erase(40);
+  REQUIRE(3 == set.size());
+  REQUIRE(20.0f == static_cast<Position*>(set.get(20))->x);
+  while (set.size()) set.erase(set.entity(0));
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2012-2014 Alec Thomas <alec@swapoff.org>
+ * All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.
+ */
+
+#include "entityx/help/ThreadPool.h"
+
+namespace entityx {
+namespace help {
+
+ThreadPool::ThreadPool(std::size_t workers) {
+  workers_.reserve(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back([this] { run(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  work_available_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+std::size_t ThreadPool::default_workers() {
+  std::size_t threads = std::thread::hardware_concurrency();
+  return threads > 1 ? threads - 1 : 0;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    ++pending_;
+  }
+  work_available_.notify_one();
+}
+
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (pending_ > 0) {
+    if (!run_one(lock)) {
+      work_done_.wait(lock);
+    }
+  }
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)> &f) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::size_t remaining = count;
+  for (std::size_t i = 0; i < count; ++i) {
+    tasks_.push_back([this, &f, &remaining, i] {
+      f(i);
+      std::unique_lock<std::mutex> lock(mutex_);
+      --remaining;
+    });
+  }
+  pending_ += count;
+  work_available_.notify_all();
+  while (remaining > 0) {
+    if (!run_one(lock)) {
+      work_done_.wait(lock);
+    }
+  }
+}
+
+void ThreadPool::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (run_one(lock)) continue;
+    if (stopping_) return;
+    work_available_.wait(lock);
+  }
+}
+
+// Pops and executes a single task with the lock released. Returns false if the queue was empty.
+bool ThreadPool::run_one(std::unique_lock<std::mutex> &lock) {
+  if (tasks_.empty()) return false;
+  std::function<void()> task = std::move(tasks_.front());
+  tasks_.pop_front();
+  lock.unlock();
+  task();
+  lock.lock();
+  --pending_;
+  // Waiters may be waiting on all tasks or only on their own parallel_for()
+  work_done_.notify_all();
+  return true;
+}
+
+}  // namespace help
+}  // namespace entityx
@@ -44,7 +44,7 @@ int main() {
     //Create pawn entity that player will control
     ex::Entity pawnEntity = EntityLibrary::Create::Entity("Player");
     pawnEntity.assign<Pawn>();
-    pawnEntity.assign<BoxCollider>()->collisionSettings.insert(COLLISION_LAYER_SETTINGS_SOLID);
+    pawnEntity.assign<BoxCollider>()->collisionSettings |= cmn::CollisionInformation::SOLID;
     ex::ComponentHandle<rvn::Renderer> pawnRend = pawnEntity.assign<rvn::Renderer>();
     RenderableSprite* pawnSprite = new RenderableSprite("Resources/Textures/BlueDot_vibrating.png", "BlueDotIdle", 0, 0.f,0.f, cmn::ERenderingLayer::Foreground, 0);
     pawnRend->sprites.insert(std::make_pair("BlueDot", std::shared_ptr<RenderableSprite>(pawnSprite)));
@@ -57,7 +57,7 @@ int main() {
     trackerEntity.assign<Tracker>();
     trackerEntity.component<Transform>()->transform.x = 400.0f;
     trackerEntity.component<Transform>()->transform.y = 5.0f;
-    trackerEntity.assign<BoxCollider>()->collisionSettings.insert(COLLISION_LAYER_SETTINGS_SOLID);
+    trackerEntity.assign<BoxCollider>()->collisionSettings |= cmn::CollisionInformation::SOLID;
     ex::ComponentHandle<rvn::Renderer> trackerRend = trackerEntity.assign<rvn::Renderer>();
     trackerRend->sprites["BlueDot"].reset(new RenderableSprite(
         "Resources/Textures/BlueDot_vibrating.png", "BlueDotIdle", 0, 0.f,0.f, cmn::ERenderingLayer::Foreground, 0));
@@ -134,18 +134,25 @@ int main() {
         currentTime = newTime;
         accumulator += frameTime;
 
-        //If we have reached delta time value, update game systems, increment FPS counter,
-        //subtract delta time from accumulator so we don't lose any leftover time,
-        //and clear window to prepare for next display.
+        //If we have fallen further behind than we may catch up on in one frame, drop the excess
+        //time rather than letting the simulation steps pile up (the "spiral of death").
+        if (accumulator > FPS_100_TICK_TIME * MAX_CATCH_UP_STEPS) {
+            accumulator = FPS_100_TICK_TIME * MAX_CATCH_UP_STEPS;
+        }
+
+        game.pollEvents();
+
+        //Advance the simulation in fixed steps, keeping any leftover time for the next frame
         while (accumulator >= FPS_100_TICK_TIME) {
-            game.pollEvents();
-            game.clearWindow();
-            //game.editMode ? game.updateEditMode(frameTime) : game.updateGameMode(frameTime);
-            game.updateGameMode(frameTime);
-            fps++;
+            game.updateGameMode(FPS_100_TICK_TIME);
             accumulator -= FPS_100_TICK_TIME;
         }
 
+        //Draw once per displayed frame, part of the way towards the next simulation step
+        game.clearWindow();
+        //game.editMode ? game.updateEditMode(frameTime) : game.renderGameMode(frameTime, accumulator / FPS_100_TICK_TIME);
+        game.renderGameMode(frameTime, (float)(accumulator / FPS_100_TICK_TIME));
+        fps++;
         game.displayWindow();
     }
 